@@ -16,6 +16,7 @@ re_ascii_version = r'#define ASCII23_VERSION_NAME "(.+?)"'
 re_doc_comment = r'((?:/\*\*.*\s*)(?:\*.+\s*)*(?:\s*\*/))'
 re_constant = re_doc_comment + r'\s*const(.+?([a-zA-Z0-9_]+)\s*)=(.+?);'
 re_constant_array = re_doc_comment + r'\s*const(.+?([a-zA-Z0-9_]+)\s*\[.*?\]\s*)=\s*\{'
+re_struct = re_doc_comment + r'\s*struct\s+([a-zA-Z0-9_]+)\s*\{([\s\S]*?)\n\};'
 re_api_function = re_doc_comment + r'\s*ASCII23_API\s*(.+?([a-zA-Z0-9_]+)\(.*?\));'
 
 def format_doc(doc):
@@ -58,6 +59,16 @@ class DocConstantArray:
     name: str
     id: str
 
+doc_structs = []
+@dataclasses.dataclass
+class DocStruct:
+    match: re.Match
+    doc: str
+    body: str
+    name: str
+    short_name: str
+    id: str
+
 doc_api_functions = []
 @dataclasses.dataclass
 class DocApiFunction:
@@ -88,6 +99,17 @@ for match in re.finditer(re_constant_array, ascii_src):
         id = format_id(name),
     ))
 
+for match in re.finditer(re_struct, ascii_src):
+    name = ascii_namespace + match.group(2).strip()
+    doc_structs.append(DocStruct(
+        match = match,
+        doc = format_doc(match.group(1)),
+        body = match.group(3).strip("\n"),
+        name = name,
+        short_name = match.group(2).strip(),
+        id = format_id(name),
+    ))
+
 for match in re.finditer(re_api_function, ascii_src):
     name = ascii_namespace + match.group(3).strip()
     doc_api_functions.append(DocApiFunction(
@@ -98,6 +120,16 @@ for match in re.finditer(re_api_function, ascii_src):
         id = format_id(name),
     ))
 
+# Overloaded functions share a heading name, so give each repeated
+# heading the same "-1", "-2", etc. suffix that GitHub uses for its anchor.
+doc_ids_seen = {}
+for item in doc_api_functions + doc_structs + doc_constant_arrays + doc_constants:
+    if item.id in doc_ids_seen:
+        doc_ids_seen[item.id] += 1
+        item.id = "%s-%d" % (item.id, doc_ids_seen[item.id])
+    else:
+        doc_ids_seen[item.id] = 0
+
 md_toc_template = "* * [%(name)s](#%(id)s)"
 
 md_constant_template = """
@@ -120,6 +152,18 @@ const %(declaration)s = {...};
 ```
 """.strip()
 
+md_struct_template = """
+### %(name)s
+
+%(doc)s
+
+``` cpp
+struct %(short_name)s {
+%(body)s
+};
+```
+""".strip()
+
 md_api_function_template = """
 ### %(name)s
 
@@ -156,6 +200,8 @@ For more information about the ascii23 library, see the project's
 
 * [Functions](#functions)
 %(api_functions_toc)s
+* [Types](#types)
+%(structs_toc)s
 * [Constants](#constants)
 %(constant_arrays_toc)s
 %(constants_toc)s
@@ -164,6 +210,10 @@ For more information about the ascii23 library, see the project's
 
 %(api_functions)s
 
+## Types
+
+%(structs)s
+
 ## Constants
 
 %(constant_arrays)s
@@ -188,6 +238,14 @@ md_docs = md_body_template % {
         lambda i: md_toc_template % dataclasses.asdict(i),
         doc_api_functions
     )),
+    "structs_toc": "\n".join(map(
+        lambda i: md_toc_template % dataclasses.asdict(i),
+        doc_structs
+    )),
+    "structs": "\n\n".join(map(
+        lambda i: md_struct_template % dataclasses.asdict(i),
+        doc_structs
+    )),
     "constants": "\n\n".join(map(
         lambda i: md_constant_template % dataclasses.asdict(i),
         doc_constants
@@ -62,6 +62,45 @@
     #define ASCII23_API
 #endif
 
+// Buffer functions are vectorized using SSE2, SSSE3, and AVX2 when the
+// compiler is targeting those instruction sets, e.g. via `-mavx2`.
+// Define `ASCII23_NO_SIMD` to always use the portable scalar code instead.
+#if defined(ASCII23_DEFINE_API) && !defined(ASCII23_NO_SIMD)
+    #if defined(__AVX2__)
+        #define ASCII23_SIMD_AVX2
+    #endif
+    #if defined(__SSSE3__) || defined(__AVX2__)
+        #define ASCII23_SIMD_SSSE3
+    #endif
+    #if defined(__SSE2__) || defined(_M_X64) || ( \
+        defined(_M_IX86_FP) && _M_IX86_FP >= 2 \
+    )
+        #define ASCII23_SIMD_SSE2
+    #endif
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define ASCII23_FORCE_INLINE __forceinline
+#else
+    #define ASCII23_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(ASCII23_SIMD_AVX2)
+    #include <immintrin.h>
+#elif defined(ASCII23_SIMD_SSSE3)
+    #include <tmmintrin.h>
+#elif defined(ASCII23_SIMD_SSE2)
+    #include <emmintrin.h>
+#endif
+
 namespace ascii {
 
 /** In `char_flags_array`: No flag. */
@@ -421,176 +460,5614 @@ ASCII23_API int to_lower_char(const int ch);
  */
 ASCII23_API int to_upper_char(const int ch);
 
-#if defined(ASCII23_DEFINE_API)
+/**
+ * Returns the value of a decimal digit `0-9`, or -1 for any
+ * other input.
+ */
+ASCII23_API int digit_value(const int ch);
 
-ASCII23_INLINE bool is_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f);
-}
+/**
+ * Returns the value of a hexadecimal digit `0-9`, `a-f`, or `A-F`,
+ * or -1 for any other input.
+ */
+ASCII23_API int hex_digit_value(const int ch);
 
-ASCII23_INLINE bool is_alpha_char(const int ch) {
-    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
-}
+/**
+ * Returns the value of a digit in the given base, where `base` is
+ * in the range 2-36. Digits are `0-9` followed by `a-z` or `A-Z`.
+ * Returns -1 for inputs that aren't a digit in that base.
+ */
+ASCII23_API int radix_digit_value(const int ch, const int base);
 
-ASCII23_INLINE bool is_alpha_lower_char(const int ch) {
-    return (ch >= 'a' && ch <= 'z');
-}
+/**
+ * Converts every `A-Z` byte in a buffer to `a-z`, in place.
+ * All other bytes, including non-ASCII bytes, are left unchanged.
+ */
+ASCII23_API void to_lower(char* str, const size_t length);
 
-ASCII23_INLINE bool is_alpha_upper_char(const int ch) {
-    return (ch >= 'A' && ch <= 'Z');
-}
+/**
+ * Writes `length` bytes to `dst`, converting `A-Z` in the source
+ * buffer to `a-z` and copying all other bytes unchanged.
+ * The buffers may be the same, but must not otherwise overlap.
+ */
+ASCII23_API void to_lower(const char* src, const size_t length, char* dst);
 
-ASCII23_INLINE bool is_digit_char(const int ch) {
-    return (ch >= '0' && ch <= '9');
-}
+/**
+ * Converts every `a-z` byte in a buffer to `A-Z`, in place.
+ * All other bytes, including non-ASCII bytes, are left unchanged.
+ */
+ASCII23_API void to_upper(char* str, const size_t length);
 
-ASCII23_INLINE bool is_hex_digit_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        char_flags_array[ch] & CHAR_FLAG_HEX_DIGIT
-    );
-    // Equivalent behavior, slower benchmark
-    // return (
-    //     (ch >= '0' && ch <= '9') ||
-    //     (ch >= 'A' && ch <= 'F') ||
-    //     (ch >= 'a' && ch <= 'f')
-    // );
-}
+/**
+ * Writes `length` bytes to `dst`, converting `a-z` in the source
+ * buffer to `A-Z` and copying all other bytes unchanged.
+ * The buffers may be the same, but must not otherwise overlap.
+ */
+ASCII23_API void to_upper(const char* src, const size_t length, char* dst);
 
-ASCII23_INLINE bool is_hex_digit_lower_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        (char_flags_array[ch] & (CHAR_FLAG_HEX_DIGIT | CHAR_FLAG_UPPER)) ==
-        CHAR_FLAG_HEX_DIGIT
-    );
-    // Equivalent behavior, slower benchmark
-    // return (
-    //     (ch >= '0' && ch <= '9') ||
-    //     (ch >= 'a' && ch <= 'f')
-    // );
-}
+/**
+ * Returns true when every byte in a buffer is an ASCII character,
+ * i.e. a value in the range `0x00-0x7f`.
+ * Returns true for an empty buffer.
+ */
+ASCII23_API bool is_all_ascii(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_hex_digit_upper_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        (char_flags_array[ch] & (CHAR_FLAG_HEX_DIGIT | CHAR_FLAG_LOWER)) ==
-        CHAR_FLAG_HEX_DIGIT
-    );
-    // Equivalent behavior, slower benchmark
-    // return (
-    //     (ch >= '0' && ch <= '9') ||
-    //     (ch >= 'A' && ch <= 'F')
-    // );
-}
+/**
+ * Returns the number of bytes at the start of a buffer that are ASCII
+ * characters, i.e. the index of the first byte `0x80-0xff`.
+ * Returns `length` when every byte is ASCII.
+ */
+ASCII23_API size_t ascii_prefix_length(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_word_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        char_flags_array[ch] & CHAR_FLAG_WORD
-    );
-    // Equivalent behavior, slower benchmark
-    // return ch == '_' || (
-    //     (ch >= '0' && ch <= '9') ||
-    //     (ch >= 'A' && ch <= 'Z') ||
-    //     (ch >= 'a' && ch <= 'z')
-    // );
-}
+/**
+ * Value returned by search functions such as `find_first_whitespace`
+ * when no matching byte was found.
+ */
+const size_t npos = static_cast<size_t>(-1);
 
-ASCII23_INLINE bool is_word_lower_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        (char_flags_array[ch] & (CHAR_FLAG_WORD | CHAR_FLAG_UPPER)) ==
-        CHAR_FLAG_WORD
-    );
-    // Equivalent behavior, slower benchmark
-    // return ch == '_' || (
-    //     (ch >= '0' && ch <= '9') ||
-    //     (ch >= 'a' && ch <= 'z')
-    // );
-}
+/**
+ * Returns the index of the first byte in a buffer with any of the
+ * given `CHAR_FLAG_*` flags set in `char_flags_array`,
+ * or `npos` if there is none. Non-ASCII bytes never match.
+ */
+ASCII23_API size_t find_first_flags(const char* str, const size_t length, const int flags);
 
-ASCII23_INLINE bool is_word_upper_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        (char_flags_array[ch] & (CHAR_FLAG_WORD | CHAR_FLAG_LOWER)) ==
-        CHAR_FLAG_WORD
-    );
-    // Equivalent behavior, slower benchmark
-    // return ch == '_' || (
-    //     (ch >= '0' && ch <= '9') ||
-    //     (ch >= 'A' && ch <= 'Z')
-    // );
-}
+/**
+ * Returns the index of the first byte in a buffer with none of the
+ * given `CHAR_FLAG_*` flags set in `char_flags_array`,
+ * or `npos` if there is none. Non-ASCII bytes always match.
+ */
+ASCII23_API size_t find_first_not_flags(const char* str, const size_t length, const int flags);
 
-ASCII23_INLINE bool is_word_start_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        char_flags_array[ch] & CHAR_FLAG_WORD_START
-    );
-    // Equivalent behavior, slower benchmark
-    // return ch == '_' || (
-    //     (ch >= 'A' && ch <= 'Z') ||
-    //     (ch >= 'a' && ch <= 'z')
-    // );
-}
+/**
+ * Returns the index of the last byte in a buffer with any of the
+ * given `CHAR_FLAG_*` flags set in `char_flags_array`,
+ * or `npos` if there is none. Non-ASCII bytes never match.
+ */
+ASCII23_API size_t find_last_flags(const char* str, const size_t length, const int flags);
 
-ASCII23_INLINE bool is_word_lower_start_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        (char_flags_array[ch] & (CHAR_FLAG_WORD_START | CHAR_FLAG_UPPER)) ==
-        CHAR_FLAG_WORD_START
-    );
-    // Equivalent behavior, slower benchmark
-    // return ch == '_' || (ch >= 'a' && ch <= 'z');
-}
+/**
+ * Returns the index of the last byte in a buffer with none of the
+ * given `CHAR_FLAG_*` flags set in `char_flags_array`,
+ * or `npos` if there is none. Non-ASCII bytes always match.
+ */
+ASCII23_API size_t find_last_not_flags(const char* str, const size_t length, const int flags);
 
-ASCII23_INLINE bool is_word_upper_start_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        (char_flags_array[ch] & (CHAR_FLAG_WORD_START | CHAR_FLAG_LOWER)) ==
-        CHAR_FLAG_WORD_START
-    );
-    // Equivalent behavior, slower benchmark
-    // return ch == '_' || (ch >= 'A' && ch <= 'Z');
-}
+/**
+ * Returns the index of the first alphabetical character in a buffer,
+ * per `is_alpha_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_alpha(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_punctuation_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        char_flags_array[ch] & CHAR_FLAG_PUNCTUATION
-    );
-    // Equivalent behavior, slower benchmark
-    // return (
-    //     (ch >= '!' && ch <= '/') ||
-    //     (ch >= ':' && ch <= '@') ||
-    //     (ch >= '[' && ch <= '`') ||
-    //     (ch >= '{' && ch <= '~')
-    // );
-}
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * an alphabetical character, per `is_alpha_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_alpha(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_whitespace_char(const int ch) {
-    return (ch >= 0 && ch <= 0x7f) && (
-        char_flags_array[ch] & CHAR_FLAG_WHITESPACE
-    );
-    // Equivalent behavior, slower benchmark
-    // return ch == ' ' || (ch >= '\t' && ch <= '\r');
-}
+/**
+ * Returns the index of the last alphabetical character in a buffer,
+ * per `is_alpha_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_alpha(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_blank_char(const int ch) {
-    return ch == ' ' || ch == '\t';
-}
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * an alphabetical character, per `is_alpha_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_alpha(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_null_char(const int ch) {
-    return ch == 0x00;
-}
+/**
+ * Returns the index of the first lower-case alphabetical character in a buffer,
+ * per `is_alpha_lower_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_alpha_lower(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_control_char(const int ch) {
-    return (ch >= 0x00 && ch <= 0x1f) || ch == 0x7f;
-}
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a lower-case alphabetical character, per `is_alpha_lower_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_alpha_lower(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_printable_char(const int ch) {
-    return ch >= 0x20 && ch <= 0x7e;
-}
+/**
+ * Returns the index of the last lower-case alphabetical character in a buffer,
+ * per `is_alpha_lower_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_alpha_lower(const char* str, const size_t length);
 
-ASCII23_INLINE bool is_graphical_char(const int ch) {
-    return ch >= 0x21 && ch <= 0x7e;
-}
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a lower-case alphabetical character, per `is_alpha_lower_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_alpha_lower(const char* str, const size_t length);
 
-ASCII23_INLINE int to_lower_char(const int ch) {
-    return (ch >= 'A' && ch <= 'Z') ? ch | 0x20 : ch;
-}
+/**
+ * Returns the index of the first upper-case alphabetical character in a buffer,
+ * per `is_alpha_upper_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_alpha_upper(const char* str, const size_t length);
 
-ASCII23_INLINE int to_upper_char(const int ch) {
-    return (ch >= 'a' && ch <= 'z') ? ch & 0xdf : ch;
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * an upper-case alphabetical character, per `is_alpha_upper_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_alpha_upper(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last upper-case alphabetical character in a buffer,
+ * per `is_alpha_upper_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_alpha_upper(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * an upper-case alphabetical character, per `is_alpha_upper_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_alpha_upper(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first decimal digit character in a buffer,
+ * per `is_digit_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_digit(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a decimal digit character, per `is_digit_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_digit(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last decimal digit character in a buffer,
+ * per `is_digit_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_digit(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a decimal digit character, per `is_digit_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_digit(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first hexadecimal digit character in a buffer,
+ * per `is_hex_digit_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_hex_digit(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a hexadecimal digit character, per `is_hex_digit_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_hex_digit(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last hexadecimal digit character in a buffer,
+ * per `is_hex_digit_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_hex_digit(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a hexadecimal digit character, per `is_hex_digit_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_hex_digit(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first word character in a buffer,
+ * per `is_word_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_word(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a word character, per `is_word_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_word(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last word character in a buffer,
+ * per `is_word_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_word(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a word character, per `is_word_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_word(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first word start character in a buffer,
+ * per `is_word_start_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_word_start(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a word start character, per `is_word_start_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_word_start(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last word start character in a buffer,
+ * per `is_word_start_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_word_start(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a word start character, per `is_word_start_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_word_start(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first punctuation character in a buffer,
+ * per `is_punctuation_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_punctuation(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a punctuation character, per `is_punctuation_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_punctuation(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last punctuation character in a buffer,
+ * per `is_punctuation_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_punctuation(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a punctuation character, per `is_punctuation_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_punctuation(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first whitespace character in a buffer,
+ * per `is_whitespace_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_whitespace(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a whitespace character, per `is_whitespace_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_whitespace(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last whitespace character in a buffer,
+ * per `is_whitespace_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_whitespace(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a whitespace character, per `is_whitespace_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_whitespace(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first blank character in a buffer,
+ * per `is_blank_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_blank(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a blank character, per `is_blank_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_blank(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last blank character in a buffer,
+ * per `is_blank_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_blank(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a blank character, per `is_blank_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_blank(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first control character in a buffer,
+ * per `is_control_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_control(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a control character, per `is_control_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_control(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last control character in a buffer,
+ * per `is_control_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_control(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a control character, per `is_control_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_control(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first printable character in a buffer,
+ * per `is_printable_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_printable(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a printable character, per `is_printable_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_printable(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last printable character in a buffer,
+ * per `is_printable_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_printable(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a printable character, per `is_printable_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_printable(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first graphical character in a buffer,
+ * per `is_graphical_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_graphical(const char* str, const size_t length);
+
+/**
+ * Returns the index of the first byte in a buffer that is not
+ * a graphical character, per `is_graphical_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_graphical(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last graphical character in a buffer,
+ * per `is_graphical_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_graphical(const char* str, const size_t length);
+
+/**
+ * Returns the index of the last byte in a buffer that is not
+ * a graphical character, per `is_graphical_char`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_graphical(const char* str, const size_t length);
+
+/**
+ * Number of bytes in a buffer having each `CHAR_FLAG_*` flag set
+ * in `char_flags_array`, as computed by `class_histogram`.
+ * The `non_ascii` field counts bytes `0x80-0xff`, which have no flags.
+ */
+struct char_class_histogram {
+    uint64_t alpha; // CHAR_FLAG_ALPHA
+    uint64_t lower; // CHAR_FLAG_LOWER
+    uint64_t upper; // CHAR_FLAG_UPPER
+    uint64_t digit; // CHAR_FLAG_DIGIT
+    uint64_t hex_digit; // CHAR_FLAG_HEX_DIGIT
+    uint64_t word; // CHAR_FLAG_WORD
+    uint64_t word_start; // CHAR_FLAG_WORD_START
+    uint64_t punctuation; // CHAR_FLAG_PUNCTUATION
+    uint64_t whitespace; // CHAR_FLAG_WHITESPACE
+    uint64_t blank; // CHAR_FLAG_BLANK
+    uint64_t control; // CHAR_FLAG_CONTROL
+    uint64_t printable; // CHAR_FLAG_PRINTABLE
+    uint64_t graphical; // CHAR_FLAG_GRAPHICAL
+    uint64_t non_ascii;
+};
+
+/**
+ * Counts the bytes in a buffer belonging to every character class
+ * described by the `CHAR_FLAG_*` constants, and the non-ASCII bytes,
+ * in a single pass.
+ */
+ASCII23_API char_class_histogram class_histogram(const char* str, const size_t length);
+
+/**
+ * Number of bytes classified at once by `classify_block`
+ * and `classify_block_flags`.
+ */
+const size_t CLASSIFY_BLOCK_SIZE = 64;
+
+/**
+ * Bit masks describing a 64-byte block, as computed by `classify_block`.
+ * Bit `i` of a mask is set when byte `i` of the block has the
+ * corresponding `CHAR_FLAG_*` flag set in `char_flags_array`.
+ * The `non_ascii` mask has a bit set for every byte `0x80-0xff`.
+ */
+struct char_block_masks {
+    uint64_t alpha; // CHAR_FLAG_ALPHA
+    uint64_t lower; // CHAR_FLAG_LOWER
+    uint64_t upper; // CHAR_FLAG_UPPER
+    uint64_t digit; // CHAR_FLAG_DIGIT
+    uint64_t hex_digit; // CHAR_FLAG_HEX_DIGIT
+    uint64_t word; // CHAR_FLAG_WORD
+    uint64_t word_start; // CHAR_FLAG_WORD_START
+    uint64_t punctuation; // CHAR_FLAG_PUNCTUATION
+    uint64_t whitespace; // CHAR_FLAG_WHITESPACE
+    uint64_t blank; // CHAR_FLAG_BLANK
+    uint64_t control; // CHAR_FLAG_CONTROL
+    uint64_t printable; // CHAR_FLAG_PRINTABLE
+    uint64_t graphical; // CHAR_FLAG_GRAPHICAL
+    uint64_t non_ascii;
+};
+
+/**
+ * Classifies the 64 bytes starting at `block`, computing one mask
+ * for every `CHAR_FLAG_*` flag included in `flags`. The masks for
+ * flags that were not requested are set to zero.
+ * Masks can be scanned with popcount and count-trailing-zeros
+ * instructions instead of testing every byte with a char function.
+ */
+ASCII23_API char_block_masks classify_block(const char* block, const int flags);
+
+/**
+ * Classifies the 64 bytes starting at `block`, returning a mask
+ * where bit `i` is set when byte `i` has any of the given
+ * `CHAR_FLAG_*` flags set in `char_flags_array`.
+ */
+ASCII23_API uint64_t classify_block_flags(const char* block, const int flags);
+
+namespace detail {
+
+// Bit representing a character in the layout used by `char_set`,
+// or 0 if the character isn't in the given half of the layout.
+// Half 0 holds characters with a low nibble of 0-7, half 1 those with
+// a low nibble of 8-f. Each byte holds the characters sharing a low
+// nibble, with the high nibble selecting a bit within that byte.
+constexpr uint64_t char_set_bit(const int ch, const int half) {
+    return (ch >= 0 && ch <= 0x7f && ((ch >> 3) & 1) == half) ? (
+        static_cast<uint64_t>(1) << (((ch & 0x7) << 3) | (ch >> 4))
+    ) : 0;
+}
+
+// Bits for the characters in `chars[begin, end)`.
+// Recursion splits the range in half, to keep the depth low.
+constexpr uint64_t char_set_string_bits(
+    const char* chars, const size_t begin, const size_t end, const int half
+) {
+    return (end - begin == 0) ? 0 : (end - begin == 1) ? (
+        char_set_bit(static_cast<unsigned char>(chars[begin]), half)
+    ) : (
+        char_set_string_bits(chars, begin, (begin + end) / 2, half) |
+        char_set_string_bits(chars, (begin + end) / 2, end, half)
+    );
+}
+
+// Bits for the characters `first` to `last`, inclusive.
+constexpr uint64_t char_set_range_bits(
+    const int first, const int last, const int half
+) {
+    return (first > last) ? 0 : (first == last) ? (
+        char_set_bit(first, half)
+    ) : (
+        char_set_range_bits(first, (first + last) / 2, half) |
+        char_set_range_bits((first + last) / 2 + 1, last, half)
+    );
+}
+
+} // namespace detail
+
+/**
+ * A set of ASCII characters, stored as a 128-bit bitmap.
+ * Sets can be built at compile time from string literals and ranges,
+ * and combined with the `|`, `&`, and `~` operators, e.g.
+ * `constexpr ascii::char_set hex = ascii::char_set("0123456789abcdef");`
+ * or `ascii::char_set::range('a', 'z') | ascii::char_set("-._~")`.
+ * Non-ASCII bytes are never members of a set.
+ * The bitmap layout matches the nibble tables used by SIMD
+ * shuffle instructions, so sets can be used as lookup tables directly.
+ */
+struct char_set {
+    // Bit `8 * (ch & 0x7) + (ch >> 4)` of `low` is set for members
+    // `ch` with a low nibble of 0-7, and of `high` for those with 8-f.
+    uint64_t low;
+    uint64_t high;
+    
+    // The empty set.
+    constexpr char_set() : low(0), high(0) {}
+    
+    constexpr char_set(const uint64_t low_bits, const uint64_t high_bits) :
+        low(low_bits), high(high_bits) {}
+    
+    // Set containing every character in a string literal.
+    template<size_t N>
+    constexpr char_set(const char (&chars)[N]) :
+        low(detail::char_set_string_bits(chars, 0, N - 1, 0)),
+        high(detail::char_set_string_bits(chars, 0, N - 1, 1)) {}
+    
+    // Set containing the characters `first` to `last`, inclusive.
+    static constexpr char_set range(const int first, const int last) {
+        return char_set(
+            detail::char_set_range_bits(first, last, 0),
+            detail::char_set_range_bits(first, last, 1)
+        );
+    }
+    
+    // True when `ch` is a member of the set.
+    constexpr bool contains(const int ch) const {
+        return ch >= 0 && ch <= 0x7f && (
+            (((ch & 0x8) ? high : low) >> (((ch & 0x7) << 3) | (ch >> 4))) & 1
+        );
+    }
+    
+    constexpr char_set operator|(const char_set other) const {
+        return char_set(low | other.low, high | other.high);
+    }
+    
+    constexpr char_set operator&(const char_set other) const {
+        return char_set(low & other.low, high & other.high);
+    }
+    
+    // Every ASCII character that isn't in the set.
+    constexpr char_set operator~() const {
+        return char_set(~low, ~high);
+    }
+    
+    constexpr bool operator==(const char_set other) const {
+        return low == other.low && high == other.high;
+    }
+    
+    constexpr bool operator!=(const char_set other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Returns a `char_set` containing every character having any of the
+ * given `CHAR_FLAG_*` flags set in `char_flags_array`.
+ */
+ASCII23_API char_set char_set_from_flags(const int flags);
+
+/**
+ * Returns the index of the first byte in a buffer that is a member
+ * of a `char_set`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_in(const char* str, const size_t length, const char_set set);
+
+/**
+ * Returns the index of the first byte in a buffer that is not a member
+ * of a `char_set`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_first_not_in(const char* str, const size_t length, const char_set set);
+
+/**
+ * Returns the index of the last byte in a buffer that is a member
+ * of a `char_set`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_in(const char* str, const size_t length, const char_set set);
+
+/**
+ * Returns the index of the last byte in a buffer that is not a member
+ * of a `char_set`, or `npos` if there is none.
+ */
+ASCII23_API size_t find_last_not_in(const char* str, const size_t length, const char_set set);
+
+/**
+ * Returns true when every byte in a buffer is a member of a `char_set`.
+ * Returns true for an empty buffer.
+ */
+ASCII23_API bool all_in(const char* str, const size_t length, const char_set set);
+
+/**
+ * Returns true when two buffers are equal, ignoring the case
+ * of `a-z` and `A-Z`. Other bytes, including non-ASCII bytes,
+ * must match exactly.
+ */
+ASCII23_API bool equals_ci(const char* a, const size_t a_length, const char* b, const size_t b_length);
+
+/**
+ * Same as `equals_ci`, but faster when `lower` is known not to
+ * contain any `A-Z` characters, e.g. a lower-case keyword.
+ * Returns false if `lower` contains any `A-Z` characters.
+ */
+ASCII23_API bool equals_ci_lower(const char* str, const size_t length, const char* lower, const size_t lower_length);
+
+/**
+ * Compares two buffers lexicographically, ignoring the case of
+ * `a-z` and `A-Z`, with the same ordering as `strcasecmp` in the
+ * C locale. Bytes are compared as unsigned values after converting
+ * `A-Z` to `a-z`, and a buffer is ordered before any longer buffer
+ * that it is a prefix of.
+ * Returns a negative value if `a` is ordered first, a positive value
+ * if `b` is ordered first, or zero if they are equal.
+ */
+ASCII23_API int compare_ci(const char* a, const size_t a_length, const char* b, const size_t b_length);
+
+/**
+ * Returns true when a buffer begins with a prefix, ignoring the case
+ * of `a-z` and `A-Z`.
+ */
+ASCII23_API bool starts_with_ci(const char* str, const size_t length, const char* prefix, const size_t prefix_length);
+
+/**
+ * Returns true when a buffer ends with a suffix, ignoring the case
+ * of `a-z` and `A-Z`.
+ */
+ASCII23_API bool ends_with_ci(const char* str, const size_t length, const char* suffix, const size_t suffix_length);
+
+/**
+ * Computes a 64-bit hash of a buffer, ignoring the case of `a-z` and
+ * `A-Z`, so that buffers which are equal per `equals_ci` have equal
+ * hashes. Case is folded while hashing, without copying the buffer.
+ * The hash is not cryptographically secure. It is the same with and
+ * without SIMD, but may differ between little- and big-endian platforms.
+ */
+ASCII23_API uint64_t hash_ci(const char* str, const size_t length, const uint64_t seed);
+
+/**
+ * A range of bytes within a buffer, as an offset from the start
+ * of the buffer and a length.
+ * Used by functions such as `trim` to refer to part of a buffer
+ * without copying it.
+ */
+struct span {
+    size_t offset;
+    size_t length;
+};
+
+/**
+ * Returns the part of a buffer remaining after removing whitespace
+ * from both the start and the end, without modifying the buffer.
+ * `flags` determines which bytes are removed: `CHAR_FLAG_WHITESPACE`
+ * per `is_whitespace_char`, or `CHAR_FLAG_BLANK` per `is_blank_char`.
+ * Returns an empty span at the end of the buffer when every byte
+ * would be removed.
+ */
+ASCII23_API span trim(const char* str, const size_t length, const int flags = CHAR_FLAG_WHITESPACE);
+
+/**
+ * Returns the part of a buffer remaining after removing whitespace
+ * from the start, without modifying the buffer.
+ * `flags` determines which bytes are removed, the same as for `trim`.
+ * Returns an empty span at the end of the buffer when every byte
+ * would be removed.
+ */
+ASCII23_API span ltrim(const char* str, const size_t length, const int flags = CHAR_FLAG_WHITESPACE);
+
+/**
+ * Returns the part of a buffer remaining after removing whitespace
+ * from the end, without modifying the buffer.
+ * `flags` determines which bytes are removed, the same as for `trim`.
+ * Returns an empty span at the start of the buffer when every byte
+ * would be removed.
+ */
+ASCII23_API span rtrim(const char* str, const size_t length, const int flags = CHAR_FLAG_WHITESPACE);
+
+/**
+ * Splits a buffer into tokens separated by runs of delimiter bytes,
+ * writing the offset and length of each token to `tokens`.
+ * Delimiters are the bytes that have any of the given `flags`,
+ * e.g. `CHAR_FLAG_WHITESPACE`. Empty tokens are never produced.
+ * Bytes before `offset` are ignored.
+ * Returns the number of tokens written, which is at most `max_tokens`.
+ * When the result equals `max_tokens`, there may be more tokens.
+ * They can be found by calling again with `offset` set to the end of
+ * the last token that was written.
+ */
+ASCII23_API size_t tokenize_flags(const char* str, const size_t length, const size_t offset, const int flags, span* tokens, const size_t max_tokens);
+
+/**
+ * Splits a buffer into tokens separated by runs of delimiter bytes,
+ * where delimiters are the bytes in a `char_set`.
+ * Otherwise behaves the same as `tokenize_flags`.
+ */
+ASCII23_API size_t tokenize_in(const char* str, const size_t length, const size_t offset, const char_set set, span* tokens, const size_t max_tokens);
+
+/** In `identifier_span`: The identifier has no letters, e.g. `_1`. */
+const int IDENTIFIER_CASE_NONE = 0x0;
+
+/** In `identifier_span`: All of the identifier's letters are `a-z`. */
+const int IDENTIFIER_CASE_LOWER = 0x1;
+
+/** In `identifier_span`: All of the identifier's letters are `A-Z`. */
+const int IDENTIFIER_CASE_UPPER = 0x2;
+
+/**
+ * In `identifier_span`: The identifier has both `a-z` and `A-Z` letters.
+ * Equal to `IDENTIFIER_CASE_LOWER | IDENTIFIER_CASE_UPPER`.
+ */
+const int IDENTIFIER_CASE_MIXED = 0x3;
+
+/**
+ * An identifier found by `scan_identifier` or `next_identifier`.
+ * An identifier is a byte with `CHAR_FLAG_WORD_START` followed by
+ * any number of bytes with `CHAR_FLAG_WORD`.
+ * `letter_case` is one of the `IDENTIFIER_CASE_*` constants.
+ */
+struct identifier_span {
+    size_t offset;
+    size_t length;
+    int letter_case;
+};
+
+/**
+ * Gets the identifier at the start of a buffer.
+ * The result's length is 0 if the buffer doesn't start with
+ * a word start character, per `is_word_start_char`.
+ */
+ASCII23_API identifier_span scan_identifier(const char* str, const size_t length);
+
+/**
+ * Finds the first identifier beginning at or after `offset`.
+ * Identifiers don't begin immediately after another word character,
+ * so e.g. the `px` in `12px` is not an identifier.
+ * The result's offset is `npos` if there is no identifier.
+ * The next identifier can be found by calling again with `offset`
+ * set to the end of the identifier that was found.
+ */
+ASCII23_API identifier_span next_identifier(const char* str, const size_t length, const size_t offset);
+
+/** In `hex_decode`: Accept `0-9`, `a-f`, and `A-F`, per `is_hex_digit_char`. */
+const int HEX_CASE_ANY = 0x0;
+
+/** In `hex_decode`: Accept only `0-9` and `a-f`, per `is_hex_digit_lower_char`. */
+const int HEX_CASE_LOWER = 0x1;
+
+/** In `hex_decode`: Accept only `0-9` and `A-F`, per `is_hex_digit_upper_char`. */
+const int HEX_CASE_UPPER = 0x2;
+
+/**
+ * Write two hexadecimal digits for each byte of `src` to `dst`,
+ * high nibble first.
+ * Digits are written in lower case, or in upper case if `upper` is true.
+ * `dst` must have room for `2 * length` bytes.
+ */
+ASCII23_API void hex_encode(const char* src, const size_t length, char* dst, const bool upper = false);
+
+/**
+ * Decode pairs of hexadecimal digits in `src`, writing one byte per
+ * pair to `dst`. `dst` must have room for `length / 2` bytes.
+ * `letter_case` is one of `HEX_CASE_ANY`, `HEX_CASE_LOWER`, or
+ * `HEX_CASE_UPPER`, determining which digits are accepted.
+ * Returns `npos` if all of `src` was decoded. Otherwise, returns the
+ * offset of the first byte that isn't an accepted digit, or of the
+ * last byte if `length` is odd. Pairs before that offset are decoded.
+ */
+ASCII23_API size_t hex_decode(const char* src, const size_t length, char* dst, const int letter_case = HEX_CASE_ANY);
+
+/**
+ * Result of `parse_uint`.
+ * `length` is the number of bytes consumed, or 0 if the buffer didn't
+ * start with a digit.
+ * `overflow` is set if the number was too large to be represented,
+ * in which case `value` is the largest representable value and
+ * `length` includes every digit.
+ */
+struct parse_uint_result {
+    uint64_t value;
+    size_t length;
+    bool overflow;
+};
+
+/**
+ * Result of `parse_int`.
+ * Fields have the same meaning as in `parse_uint_result`.
+ * On overflow, `value` is the largest or smallest representable
+ * value, depending on the sign.
+ */
+struct parse_int_result {
+    int64_t value;
+    size_t length;
+    bool overflow;
+};
+
+/**
+ * Parses an unsigned integer from the digits at the start of a buffer.
+ * `base` must be in the range 2-36, with digits per `radix_digit_value`.
+ * No sign, prefix, or whitespace is accepted.
+ * Decimal digits are converted eight at a time.
+ * Unlike `strtoul`, this doesn't depend on the locale.
+ */
+ASCII23_API parse_uint_result parse_uint(const char* str, const size_t length, const int base = 10);
+
+/**
+ * Parses a signed integer from an optional `+` or `-` sign followed by
+ * the digits at the start of a buffer.
+ * Otherwise behaves the same as `parse_uint`.
+ */
+ASCII23_API parse_int_result parse_int(const char* str, const size_t length, const int base = 10);
+
+/**
+ * Result of `parse_int_fields_flags` and `parse_int_fields_in`.
+ * `count` is the number of values written.
+ * `offset` is where parsing stopped: the start of the field after the
+ * last one that was parsed, or the start of an invalid field.
+ * `invalid` is set if parsing stopped at a field that was empty,
+ * that wasn't an integer per `parse_int`, or that overflowed.
+ */
+struct parse_fields_result {
+    size_t count;
+    size_t offset;
+    bool invalid;
+};
+
+/**
+ * Parses decimal integer fields separated by delimiter bytes,
+ * writing up to `max_values` values.
+ * Delimiters are the bytes that have any of the given `flags`.
+ * Each delimiter ends one field, so two adjacent delimiters enclose
+ * an empty field, which is invalid. A delimiter at the end of the
+ * buffer doesn't start another field.
+ * Bytes before `offset` are ignored. When `count` equals `max_values`,
+ * parsing can be resumed by calling again with the result's `offset`.
+ */
+ASCII23_API parse_fields_result parse_int_fields_flags(const char* str, const size_t length, const size_t offset, const int flags, int64_t* values, const size_t max_values);
+
+/**
+ * Parses decimal integer fields separated by delimiter bytes,
+ * where delimiters are the bytes in a `char_set`.
+ * Otherwise behaves the same as `parse_int_fields_flags`.
+ */
+ASCII23_API parse_fields_result parse_int_fields_in(const char* str, const size_t length, const size_t offset, const char_set set, int64_t* values, const size_t max_values);
+
+/**
+ * Returns the number of bytes written by `format_uint` for a value.
+ */
+ASCII23_API size_t format_uint_length(const uint64_t value);
+
+/**
+ * Returns the number of bytes written by `format_int` for a value,
+ * including a `-` sign for negative values.
+ */
+ASCII23_API size_t format_int_length(const int64_t value);
+
+/**
+ * Returns the number of bytes written by `format_hex` for a value.
+ */
+ASCII23_API size_t format_hex_length(const uint64_t value);
+
+/**
+ * Writes the decimal digits of an unsigned integer to `dst`,
+ * without a terminating null byte.
+ * `dst` must have room for `format_uint_length(value)` bytes,
+ * which is at most 20.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t format_uint(const uint64_t value, char* dst);
+
+/**
+ * Writes the decimal digits of a signed integer to `dst`, preceded by
+ * `-` if the value is negative, without a terminating null byte.
+ * `dst` must have room for `format_int_length(value)` bytes,
+ * which is at most 20.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t format_int(const int64_t value, char* dst);
+
+/**
+ * Writes the hexadecimal digits of an unsigned integer to `dst`,
+ * without a prefix, leading zeros, or a terminating null byte.
+ * Digits are written in lower case, or in upper case if `upper` is true.
+ * `dst` must have room for `format_hex_length(value)` bytes,
+ * which is at most 16.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t format_hex(const uint64_t value, char* dst, const bool upper = false);
+
+/**
+ * Result of `parse_double`.
+ * `length` is the number of bytes consumed, or 0 if the buffer didn't
+ * start with a number.
+ */
+struct parse_double_result {
+    double value;
+    size_t length;
+};
+
+/**
+ * Parses a floating point number from the start of a buffer.
+ * Accepts an optional `+` or `-` sign, then digits with an optional
+ * `.` decimal point, then an optional exponent: `e` or `E` with an
+ * optional sign and digits. Also accepts `inf`, `infinity`, and `nan`,
+ * in any case.
+ * No whitespace or hexadecimal notation is accepted.
+ * The result is correctly rounded, becoming an infinity or zero when
+ * out of range.
+ * Unlike `strtod`, this doesn't depend on the locale.
+ */
+ASCII23_API parse_double_result parse_double(const char* str, const size_t length);
+
+/**
+ * Result of `parse_iso8601`.
+ * `nanoseconds` is the time since 1970-01-01T00:00:00Z.
+ * `length` is the number of bytes consumed, or 0 on error.
+ * `error` is the offset of the first invalid byte, or of the first
+ * byte of an out-of-range field, or `npos` if there was no error.
+ */
+struct parse_iso8601_result {
+    int64_t nanoseconds;
+    size_t length;
+    size_t error;
+};
+
+/**
+ * Parses an ISO 8601 or RFC 3339 timestamp from the start of a buffer,
+ * e.g. `2026-10-17T12:34:56.789Z`.
+ * The date and time are separated by `T`, `t`, or a space.
+ * The seconds can be followed by `.` or `,` and up to 9 fraction digits.
+ * Digits past the ninth are consumed but ignored.
+ * Then comes an optional `Z`, `z`, or `+HH:MM` or `-HH:MM` offset.
+ * A timestamp without an offset is treated as UTC.
+ * Times outside the range of 64-bit nanoseconds, from 1677 to 2262,
+ * are reported as errors at the year.
+ */
+ASCII23_API parse_iso8601_result parse_iso8601(const char* str, const size_t length);
+
+/**
+ * Maximum number of bytes written by `format_ipv4`.
+ */
+const size_t IPV4_MAX_LENGTH = 15;
+
+/**
+ * Number of bytes written by `format_uuid` and read by `parse_uuid`.
+ */
+const size_t UUID_LENGTH = 36;
+
+/**
+ * Result of `parse_ipv4`.
+ * `address` holds the first number of the address in its highest byte.
+ * `length` is the number of bytes consumed, or 0 on error.
+ * `error` is the offset of the first invalid byte, or of the first
+ * digit of an invalid number, or `npos` if there was no error.
+ */
+struct parse_ipv4_result {
+    uint32_t address;
+    size_t length;
+    size_t error;
+};
+
+/**
+ * Parses an IPv4 address in dotted decimal notation from the start of
+ * a buffer, e.g. `192.168.0.1`.
+ * Each of the four numbers must be in the range 0-255,
+ * with no leading zeros.
+ */
+ASCII23_API parse_ipv4_result parse_ipv4(const char* str, const size_t length);
+
+/**
+ * Writes an IPv4 address in dotted decimal notation to `dst`,
+ * without a terminating null byte.
+ * `address` holds the first number of the address in its highest byte.
+ * `dst` must have room for `IPV4_MAX_LENGTH` bytes.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t format_ipv4(const uint32_t address, char* dst);
+
+/**
+ * Parses a UUID in the `8-4-4-4-12` hexadecimal digit format,
+ * e.g. `4f9a2c1e-7b3d-4e8f-9a0b-1c2d3e4f5a6b`, writing its 16 bytes
+ * to `dst`. Digits may be in either case.
+ * `length` must be at least `UUID_LENGTH` for the parse to succeed.
+ * Returns `npos` on success. Otherwise, returns the offset of the
+ * first invalid byte.
+ */
+ASCII23_API size_t parse_uuid(const char* str, const size_t length, char* dst);
+
+/**
+ * Writes the 16 bytes at `src` as a UUID in the `8-4-4-4-12`
+ * hexadecimal digit format to `dst`, without a terminating null byte.
+ * Digits are written in lower case, or in upper case if `upper` is true.
+ * `dst` must have room for `UUID_LENGTH` bytes.
+ */
+ASCII23_API void format_uuid(const char* src, char* dst, const bool upper = false);
+
+/** In `base64_encode` and `base64_decode`: Use the standard alphabet, with `+` and `/`. */
+const int BASE64_STANDARD = 0x0;
+
+/** In `base64_encode` and `base64_decode`: Use the URL and filename safe alphabet, with `-` and `_`. */
+const int BASE64_URL = 0x1;
+
+/** In `base64_encode`: Don't write `=` padding at the end. */
+const int BASE64_NO_PADDING = 0x2;
+
+/** In `base64_decode`: Skip whitespace characters, per `is_whitespace_char`. */
+const int BASE64_SKIP_WHITESPACE = 0x4;
+
+/**
+ * Result of `base64_decode`.
+ * `length` is the number of bytes written.
+ * `error` is the offset of the first invalid byte,
+ * or `npos` if there was no error.
+ */
+struct base64_decode_result {
+    size_t length;
+    size_t error;
+};
+
+/**
+ * Get the number of bytes written by `base64_encode` for `length`
+ * bytes of input with the given `options`.
+ */
+ASCII23_API size_t base64_encoded_length(const size_t length, const int options = BASE64_STANDARD);
+
+/**
+ * Write the base64 encoding of `src` to `dst`.
+ * `options` is `BASE64_STANDARD` or `BASE64_URL`,
+ * optionally combined with `BASE64_NO_PADDING`.
+ * `dst` must have room for `base64_encoded_length(length, options)` bytes.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t base64_encode(const char* src, const size_t length, char* dst, const int options = BASE64_STANDARD);
+
+/**
+ * Decode base64 `src`, writing the decoded bytes to `dst`.
+ * `options` is `BASE64_STANDARD` or `BASE64_URL`,
+ * optionally combined with `BASE64_SKIP_WHITESPACE`.
+ * `=` padding at the end is accepted but not required.
+ * `dst` must have room for `length * 3 / 4` bytes.
+ * Bytes encoded before an invalid byte are decoded.
+ */
+ASCII23_API base64_decode_result base64_decode(const char* src, const size_t length, char* dst, const int options = BASE64_STANDARD);
+
+/**
+ * The unreserved characters of RFC 3986, which `percent_encode`
+ * leaves as they are by default: `A-Z`, `a-z`, `0-9`, and `-._~`.
+ */
+const char_set URL_UNRESERVED = char_set("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~");
+
+/**
+ * Result of `percent_decode`.
+ * `length` is the number of bytes written.
+ * `error` is the offset of the `%` starting the first invalid escape,
+ * or `npos` if there was no error.
+ */
+struct percent_decode_result {
+    size_t length;
+    size_t error;
+};
+
+/**
+ * Get the number of bytes written by `percent_encode` for `src`.
+ */
+ASCII23_API size_t percent_encoded_length(const char* src, const size_t length, const char_set unreserved = URL_UNRESERVED);
+
+/**
+ * Write `src` to `dst`, replacing each byte that isn't a member of
+ * `unreserved` with `%` and two upper case hexadecimal digits.
+ * `dst` must have room for `percent_encoded_length(src, length, unreserved)`
+ * bytes, which is at most `3 * length`.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t percent_encode(const char* src, const size_t length, char* dst, const char_set unreserved = URL_UNRESERVED);
+
+/**
+ * Decode `%` escapes of two hexadecimal digits in `src`, writing the
+ * result to `dst`. If `plus_as_space` is true, `+` is decoded as a
+ * space, as in HTML form data.
+ * `dst` must have room for `length` bytes, and may be the same as `src`
+ * to decode in place.
+ * Bytes before an invalid escape are decoded.
+ */
+ASCII23_API percent_decode_result percent_decode(const char* src, const size_t length, char* dst, const bool plus_as_space = false);
+
+/**
+ * In `escape`: Escape for the contents of a JSON string.
+ * `"` and `\` are escaped with a backslash, control characters as
+ * `\b`, `\f`, `\n`, `\r`, `\t`, or `\u00XX`.
+ * Other bytes, including UTF-8 sequences, are copied as they are.
+ */
+const int ESCAPE_JSON = 0x0;
+
+/**
+ * In `escape`: Escape for the contents of a C string literal.
+ * `"` and `\` are escaped with a backslash, control characters as
+ * `\a`, `\b`, `\t`, `\n`, `\v`, `\f`, `\r`, or three octal digits,
+ * and `0x7F` and non-ASCII bytes as three octal digits.
+ */
+const int ESCAPE_C = 0x1;
+
+/**
+ * In `escape`: Escape for HTML text and attribute values.
+ * `&`, `<`, `>`, `"`, and `'` are written as `&amp;`, `&lt;`, `&gt;`,
+ * `&quot;`, and `&#39;`.
+ */
+const int ESCAPE_HTML = 0x2;
+
+/**
+ * In `escape`: Write control characters in caret notation, e.g. `^@`
+ * for `0x00`, `^[` for `0x1B`, and `^?` for `0x7F`.
+ */
+const int ESCAPE_CARET = 0x3;
+
+/**
+ * Describes which bytes `escape` replaces, and with what.
+ * `special` holds the ASCII bytes to escape, and `non_ascii` is true
+ * when bytes `0x80-0xFF` are escaped as well.
+ * `length` returns the length of the escape for a byte, and `write`
+ * writes that many bytes to `dst` and returns the same length.
+ */
+struct escape_table {
+    char_set special;
+    bool non_ascii;
+    size_t (*length)(const unsigned char ch);
+    size_t (*write)(const unsigned char ch, char* dst);
+};
+
+/**
+ * Get the `escape_table` for `mode`, one of `ESCAPE_JSON`, `ESCAPE_C`,
+ * `ESCAPE_HTML`, or `ESCAPE_CARET`.
+ * Any other `mode` gives a table that escapes nothing.
+ */
+ASCII23_API escape_table get_escape_table(const int mode);
+
+/**
+ * Get the number of bytes written by `escape` for `src` with the
+ * given `mode`, so that output can be allocated once.
+ */
+ASCII23_API size_t escaped_length(const char* src, const size_t length, const int mode = ESCAPE_JSON);
+
+/**
+ * Get the number of bytes written by `escape` for `src` with a
+ * custom `escape_table`.
+ */
+ASCII23_API size_t escaped_length(const char* src, const size_t length, const escape_table& table);
+
+/**
+ * Write `src` to `dst`, escaping bytes according to `mode`, one of
+ * `ESCAPE_JSON`, `ESCAPE_C`, `ESCAPE_HTML`, or `ESCAPE_CARET`.
+ * Any other `mode` copies `src` unchanged.
+ * `dst` must have room for `escaped_length(src, length, mode)` bytes.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t escape(const char* src, const size_t length, char* dst, const int mode = ESCAPE_JSON);
+
+/**
+ * Write `src` to `dst`, escaping bytes according to a custom
+ * `escape_table`.
+ * `dst` must have room for `escaped_length(src, length, table)` bytes.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t escape(const char* src, const size_t length, char* dst, const escape_table& table);
+
+/**
+ * Result of `unescape_json` and `unescape_c`.
+ * `length` is the number of bytes written.
+ * `error` is the offset of the `\` starting the first malformed
+ * escape sequence, or `npos` if there was no error.
+ */
+struct unescape_result {
+    size_t length;
+    size_t error;
+};
+
+/**
+ * Decode the escape sequences of the contents of a JSON string, writing
+ * the result to `dst`. `\uXXXX` escapes, including surrogate pairs,
+ * are written as UTF-8. Unpaired surrogates are malformed.
+ * `dst` must have room for `length` bytes, and may be the same as `src`
+ * to decode in place.
+ * Bytes before a malformed escape are decoded.
+ */
+ASCII23_API unescape_result unescape_json(const char* src, const size_t length, char* dst);
+
+/**
+ * Decode the escape sequences of the contents of a C string literal,
+ * writing the result to `dst`. Octal and `\x` escapes must have values
+ * up to `0xFF`. `\u` and `\U` escapes are written as UTF-8.
+ * `dst` must have room for `length` bytes, and may be the same as `src`
+ * to decode in place.
+ * Bytes before a malformed escape are decoded.
+ */
+ASCII23_API unescape_result unescape_c(const char* src, const size_t length, char* dst);
+
+/** In `sanitize`: Replace each control character with the `replacement` byte. */
+const int SANITIZE_REPLACE = 0x0;
+
+/** In `sanitize`: Remove control characters, moving the remaining bytes toward the start of the buffer. */
+const int SANITIZE_DROP = 0x1;
+
+/** In `sanitize`: Combined with another mode, leave `\t` and `\n` characters as they are. */
+const int SANITIZE_KEEP_TAB_NEWLINE = 0x2;
+
+/**
+ * Replace or remove the control characters in a buffer, in place,
+ * per `is_control_char`. Non-ASCII bytes are left unchanged.
+ * `mode` is `SANITIZE_REPLACE` or `SANITIZE_DROP`, optionally combined
+ * with `SANITIZE_KEEP_TAB_NEWLINE`.
+ * Returns the length of the sanitized buffer, which is `length` unless
+ * control characters were dropped.
+ */
+ASCII23_API size_t sanitize(char* str, const size_t length, const int mode = SANITIZE_REPLACE, const char replacement = '?');
+
+/**
+ * Remove ANSI escape sequences from a buffer, in place, such as the
+ * `ESC [ ... m` sequences that set terminal colors.
+ * Removes CSI sequences (`ESC [`, parameters, and a final byte),
+ * OSC sequences (`ESC ]` ended by `BEL` or `ESC \`), and other two-byte
+ * or character set escapes. A sequence interrupted by an unexpected
+ * byte is removed up to that byte, and one cut off by the end of the
+ * buffer is removed entirely.
+ * Returns the length of the stripped buffer.
+ */
+ASCII23_API size_t strip_ansi_sequences(char* str, const size_t length);
+
+/**
+ * Replace every run of whitespace characters in a buffer, per
+ * `is_whitespace_char`, with a single space, and remove the whitespace
+ * at the start and end of the buffer, in place.
+ * Returns the length of the collapsed buffer.
+ */
+ASCII23_API size_t collapse_whitespace(char* str, const size_t length);
+
+/**
+ * Write `src` to `dst`, replacing every run of whitespace characters,
+ * per `is_whitespace_char`, with a single space, and leaving out the
+ * whitespace at the start and end.
+ * `dst` must have room for `length` bytes.
+ * The buffers may be the same, but must not otherwise overlap.
+ * Returns the number of bytes written.
+ */
+ASCII23_API size_t collapse_whitespace(const char* src, const size_t length, char* dst);
+
+/**
+ * Hash function object using `hash_ci`, for use with containers such as
+ * `std::unordered_map<std::string, T, ascii::hash_ci_fn, ascii::equal_ci_fn>`.
+ * Works with any string type having `data()` and `size()` members.
+ */
+struct hash_ci_fn {
+    template<typename string_type>
+    size_t operator()(const string_type& str) const {
+        return static_cast<size_t>(hash_ci(str.data(), str.size(), 0));
+    }
+};
+
+/**
+ * Equality function object using `equals_ci`, to be used together
+ * with `hash_ci_fn`. Works with any string type having `data()` and
+ * `size()` members.
+ */
+struct equal_ci_fn {
+    template<typename string_type>
+    bool operator()(const string_type& a, const string_type& b) const {
+        return equals_ci(a.data(), a.size(), b.data(), b.size());
+    }
+};
+
+#if defined(ASCII23_DEFINE_API)
+
+ASCII23_INLINE bool is_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f);
+}
+
+ASCII23_INLINE bool is_alpha_char(const int ch) {
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+ASCII23_INLINE bool is_alpha_lower_char(const int ch) {
+    return (ch >= 'a' && ch <= 'z');
+}
+
+ASCII23_INLINE bool is_alpha_upper_char(const int ch) {
+    return (ch >= 'A' && ch <= 'Z');
+}
+
+ASCII23_INLINE bool is_digit_char(const int ch) {
+    return (ch >= '0' && ch <= '9');
+}
+
+ASCII23_INLINE bool is_hex_digit_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        char_flags_array[ch] & CHAR_FLAG_HEX_DIGIT
+    );
+    // Equivalent behavior, slower benchmark
+    // return (
+    //     (ch >= '0' && ch <= '9') ||
+    //     (ch >= 'A' && ch <= 'F') ||
+    //     (ch >= 'a' && ch <= 'f')
+    // );
+}
+
+ASCII23_INLINE bool is_hex_digit_lower_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        (char_flags_array[ch] & (CHAR_FLAG_HEX_DIGIT | CHAR_FLAG_UPPER)) ==
+        CHAR_FLAG_HEX_DIGIT
+    );
+    // Equivalent behavior, slower benchmark
+    // return (
+    //     (ch >= '0' && ch <= '9') ||
+    //     (ch >= 'a' && ch <= 'f')
+    // );
+}
+
+ASCII23_INLINE bool is_hex_digit_upper_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        (char_flags_array[ch] & (CHAR_FLAG_HEX_DIGIT | CHAR_FLAG_LOWER)) ==
+        CHAR_FLAG_HEX_DIGIT
+    );
+    // Equivalent behavior, slower benchmark
+    // return (
+    //     (ch >= '0' && ch <= '9') ||
+    //     (ch >= 'A' && ch <= 'F')
+    // );
+}
+
+ASCII23_INLINE bool is_word_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        char_flags_array[ch] & CHAR_FLAG_WORD
+    );
+    // Equivalent behavior, slower benchmark
+    // return ch == '_' || (
+    //     (ch >= '0' && ch <= '9') ||
+    //     (ch >= 'A' && ch <= 'Z') ||
+    //     (ch >= 'a' && ch <= 'z')
+    // );
+}
+
+ASCII23_INLINE bool is_word_lower_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        (char_flags_array[ch] & (CHAR_FLAG_WORD | CHAR_FLAG_UPPER)) ==
+        CHAR_FLAG_WORD
+    );
+    // Equivalent behavior, slower benchmark
+    // return ch == '_' || (
+    //     (ch >= '0' && ch <= '9') ||
+    //     (ch >= 'a' && ch <= 'z')
+    // );
+}
+
+ASCII23_INLINE bool is_word_upper_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        (char_flags_array[ch] & (CHAR_FLAG_WORD | CHAR_FLAG_LOWER)) ==
+        CHAR_FLAG_WORD
+    );
+    // Equivalent behavior, slower benchmark
+    // return ch == '_' || (
+    //     (ch >= '0' && ch <= '9') ||
+    //     (ch >= 'A' && ch <= 'Z')
+    // );
+}
+
+ASCII23_INLINE bool is_word_start_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        char_flags_array[ch] & CHAR_FLAG_WORD_START
+    );
+    // Equivalent behavior, slower benchmark
+    // return ch == '_' || (
+    //     (ch >= 'A' && ch <= 'Z') ||
+    //     (ch >= 'a' && ch <= 'z')
+    // );
+}
+
+ASCII23_INLINE bool is_word_lower_start_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        (char_flags_array[ch] & (CHAR_FLAG_WORD_START | CHAR_FLAG_UPPER)) ==
+        CHAR_FLAG_WORD_START
+    );
+    // Equivalent behavior, slower benchmark
+    // return ch == '_' || (ch >= 'a' && ch <= 'z');
+}
+
+ASCII23_INLINE bool is_word_upper_start_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        (char_flags_array[ch] & (CHAR_FLAG_WORD_START | CHAR_FLAG_LOWER)) ==
+        CHAR_FLAG_WORD_START
+    );
+    // Equivalent behavior, slower benchmark
+    // return ch == '_' || (ch >= 'A' && ch <= 'Z');
+}
+
+ASCII23_INLINE bool is_punctuation_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        char_flags_array[ch] & CHAR_FLAG_PUNCTUATION
+    );
+    // Equivalent behavior, slower benchmark
+    // return (
+    //     (ch >= '!' && ch <= '/') ||
+    //     (ch >= ':' && ch <= '@') ||
+    //     (ch >= '[' && ch <= '`') ||
+    //     (ch >= '{' && ch <= '~')
+    // );
+}
+
+ASCII23_INLINE bool is_whitespace_char(const int ch) {
+    return (ch >= 0 && ch <= 0x7f) && (
+        char_flags_array[ch] & CHAR_FLAG_WHITESPACE
+    );
+    // Equivalent behavior, slower benchmark
+    // return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+ASCII23_INLINE bool is_blank_char(const int ch) {
+    return ch == ' ' || ch == '\t';
+}
+
+ASCII23_INLINE bool is_null_char(const int ch) {
+    return ch == 0x00;
+}
+
+ASCII23_INLINE bool is_control_char(const int ch) {
+    return (ch >= 0x00 && ch <= 0x1f) || ch == 0x7f;
+}
+
+ASCII23_INLINE bool is_printable_char(const int ch) {
+    return ch >= 0x20 && ch <= 0x7e;
+}
+
+ASCII23_INLINE bool is_graphical_char(const int ch) {
+    return ch >= 0x21 && ch <= 0x7e;
+}
+
+ASCII23_INLINE int to_lower_char(const int ch) {
+    return (ch >= 'A' && ch <= 'Z') ? ch | 0x20 : ch;
+}
+
+ASCII23_INLINE int to_upper_char(const int ch) {
+    return (ch >= 'a' && ch <= 'z') ? ch & 0xdf : ch;
+}
+
+ASCII23_INLINE int digit_value(const int ch) {
+    return (ch >= '0' && ch <= '9') ? ch - '0' : -1;
+}
+
+ASCII23_INLINE int hex_digit_value(const int ch) {
+    return radix_digit_value(ch, 16);
+}
+
+ASCII23_INLINE int radix_digit_value(const int ch, const int base) {
+    const int value = (
+        (ch >= '0' && ch <= '9') ? ch - '0' :
+        is_alpha_char(ch) ? (ch | 0x20) - 'a' + 10 : base
+    );
+    return value < base ? value : -1;
+}
+
+// Implementation details for the buffer functions.
+// Nothing in this namespace is part of the public API.
+namespace detail {
+
+// Index of the lowest set bit. The input must not be zero.
+ASCII23_FORCE_INLINE int count_trailing_zeros(const uint64_t x) {
+    #if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+    #elif defined(_MSC_VER)
+    unsigned long index;
+    if(_BitScanForward(&index, static_cast<unsigned long>(x))) {
+        return static_cast<int>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(x >> 32));
+    return static_cast<int>(index) + 32;
+    #else
+    return __builtin_ctzll(x);
+    #endif
+}
+
+// Index of the highest set bit. The input must not be zero.
+ASCII23_FORCE_INLINE int highest_bit_index(const uint64_t x) {
+    #if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return static_cast<int>(index);
+    #elif defined(_MSC_VER)
+    unsigned long index;
+    if(_BitScanReverse(&index, static_cast<unsigned long>(x >> 32))) {
+        return static_cast<int>(index) + 32;
+    }
+    _BitScanReverse(&index, static_cast<unsigned long>(x));
+    return static_cast<int>(index);
+    #else
+    return 63 - __builtin_clzll(x);
+    #endif
+}
+
+// Number of set bits.
+ASCII23_FORCE_INLINE int popcount(uint32_t x) {
+    #if defined(_MSC_VER)
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return static_cast<int>((((x + (x >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24);
+    #else
+    return __builtin_popcount(x);
+    #endif
+}
+
+// Read 8 bytes from a possibly unaligned pointer.
+ASCII23_FORCE_INLINE uint64_t load_u64(const char* ptr) {
+    uint64_t word;
+    std::memcpy(&word, ptr, sizeof(word));
+    return word;
+}
+
+// Read 8 bytes with the first byte in the lowest bits of the result,
+// regardless of the platform's byte order.
+ASCII23_FORCE_INLINE uint64_t load_u64_le(const char* ptr) {
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap64(load_u64(ptr));
+    #else
+    return load_u64(ptr);
+    #endif
+}
+
+// The lowest bit of every byte in a 64-bit word. Multiplying this by
+// a byte value gives a word with every byte set to that value.
+const uint64_t SWAR_ONES = 0x0101010101010101ull;
+
+// The high bit of every byte in a 64-bit word.
+const uint64_t SWAR_HIGH_BITS = 0x8080808080808080ull;
+
+#if defined(ASCII23_SIMD_SSSE3)
+// Shuffle indices that gather the bytes selected by an 8-bit mask to
+// the start of 8 bytes, in order. Unused positions are 0x80, which
+// shuffles to 0 even after adding 8 to index the upper 8 bytes.
+const uint64_t COMPACT_SHUFFLE_TABLE[256] = {
+    0x8080808080808080ull, 0x8080808080808000ull, 0x8080808080808001ull, 0x8080808080800100ull,
+    0x8080808080808002ull, 0x8080808080800200ull, 0x8080808080800201ull, 0x8080808080020100ull,
+    0x8080808080808003ull, 0x8080808080800300ull, 0x8080808080800301ull, 0x8080808080030100ull,
+    0x8080808080800302ull, 0x8080808080030200ull, 0x8080808080030201ull, 0x8080808003020100ull,
+    0x8080808080808004ull, 0x8080808080800400ull, 0x8080808080800401ull, 0x8080808080040100ull,
+    0x8080808080800402ull, 0x8080808080040200ull, 0x8080808080040201ull, 0x8080808004020100ull,
+    0x8080808080800403ull, 0x8080808080040300ull, 0x8080808080040301ull, 0x8080808004030100ull,
+    0x8080808080040302ull, 0x8080808004030200ull, 0x8080808004030201ull, 0x8080800403020100ull,
+    0x8080808080808005ull, 0x8080808080800500ull, 0x8080808080800501ull, 0x8080808080050100ull,
+    0x8080808080800502ull, 0x8080808080050200ull, 0x8080808080050201ull, 0x8080808005020100ull,
+    0x8080808080800503ull, 0x8080808080050300ull, 0x8080808080050301ull, 0x8080808005030100ull,
+    0x8080808080050302ull, 0x8080808005030200ull, 0x8080808005030201ull, 0x8080800503020100ull,
+    0x8080808080800504ull, 0x8080808080050400ull, 0x8080808080050401ull, 0x8080808005040100ull,
+    0x8080808080050402ull, 0x8080808005040200ull, 0x8080808005040201ull, 0x8080800504020100ull,
+    0x8080808080050403ull, 0x8080808005040300ull, 0x8080808005040301ull, 0x8080800504030100ull,
+    0x8080808005040302ull, 0x8080800504030200ull, 0x8080800504030201ull, 0x8080050403020100ull,
+    0x8080808080808006ull, 0x8080808080800600ull, 0x8080808080800601ull, 0x8080808080060100ull,
+    0x8080808080800602ull, 0x8080808080060200ull, 0x8080808080060201ull, 0x8080808006020100ull,
+    0x8080808080800603ull, 0x8080808080060300ull, 0x8080808080060301ull, 0x8080808006030100ull,
+    0x8080808080060302ull, 0x8080808006030200ull, 0x8080808006030201ull, 0x8080800603020100ull,
+    0x8080808080800604ull, 0x8080808080060400ull, 0x8080808080060401ull, 0x8080808006040100ull,
+    0x8080808080060402ull, 0x8080808006040200ull, 0x8080808006040201ull, 0x8080800604020100ull,
+    0x8080808080060403ull, 0x8080808006040300ull, 0x8080808006040301ull, 0x8080800604030100ull,
+    0x8080808006040302ull, 0x8080800604030200ull, 0x8080800604030201ull, 0x8080060403020100ull,
+    0x8080808080800605ull, 0x8080808080060500ull, 0x8080808080060501ull, 0x8080808006050100ull,
+    0x8080808080060502ull, 0x8080808006050200ull, 0x8080808006050201ull, 0x8080800605020100ull,
+    0x8080808080060503ull, 0x8080808006050300ull, 0x8080808006050301ull, 0x8080800605030100ull,
+    0x8080808006050302ull, 0x8080800605030200ull, 0x8080800605030201ull, 0x8080060503020100ull,
+    0x8080808080060504ull, 0x8080808006050400ull, 0x8080808006050401ull, 0x8080800605040100ull,
+    0x8080808006050402ull, 0x8080800605040200ull, 0x8080800605040201ull, 0x8080060504020100ull,
+    0x8080808006050403ull, 0x8080800605040300ull, 0x8080800605040301ull, 0x8080060504030100ull,
+    0x8080800605040302ull, 0x8080060504030200ull, 0x8080060504030201ull, 0x8006050403020100ull,
+    0x8080808080808007ull, 0x8080808080800700ull, 0x8080808080800701ull, 0x8080808080070100ull,
+    0x8080808080800702ull, 0x8080808080070200ull, 0x8080808080070201ull, 0x8080808007020100ull,
+    0x8080808080800703ull, 0x8080808080070300ull, 0x8080808080070301ull, 0x8080808007030100ull,
+    0x8080808080070302ull, 0x8080808007030200ull, 0x8080808007030201ull, 0x8080800703020100ull,
+    0x8080808080800704ull, 0x8080808080070400ull, 0x8080808080070401ull, 0x8080808007040100ull,
+    0x8080808080070402ull, 0x8080808007040200ull, 0x8080808007040201ull, 0x8080800704020100ull,
+    0x8080808080070403ull, 0x8080808007040300ull, 0x8080808007040301ull, 0x8080800704030100ull,
+    0x8080808007040302ull, 0x8080800704030200ull, 0x8080800704030201ull, 0x8080070403020100ull,
+    0x8080808080800705ull, 0x8080808080070500ull, 0x8080808080070501ull, 0x8080808007050100ull,
+    0x8080808080070502ull, 0x8080808007050200ull, 0x8080808007050201ull, 0x8080800705020100ull,
+    0x8080808080070503ull, 0x8080808007050300ull, 0x8080808007050301ull, 0x8080800705030100ull,
+    0x8080808007050302ull, 0x8080800705030200ull, 0x8080800705030201ull, 0x8080070503020100ull,
+    0x8080808080070504ull, 0x8080808007050400ull, 0x8080808007050401ull, 0x8080800705040100ull,
+    0x8080808007050402ull, 0x8080800705040200ull, 0x8080800705040201ull, 0x8080070504020100ull,
+    0x8080808007050403ull, 0x8080800705040300ull, 0x8080800705040301ull, 0x8080070504030100ull,
+    0x8080800705040302ull, 0x8080070504030200ull, 0x8080070504030201ull, 0x8007050403020100ull,
+    0x8080808080800706ull, 0x8080808080070600ull, 0x8080808080070601ull, 0x8080808007060100ull,
+    0x8080808080070602ull, 0x8080808007060200ull, 0x8080808007060201ull, 0x8080800706020100ull,
+    0x8080808080070603ull, 0x8080808007060300ull, 0x8080808007060301ull, 0x8080800706030100ull,
+    0x8080808007060302ull, 0x8080800706030200ull, 0x8080800706030201ull, 0x8080070603020100ull,
+    0x8080808080070604ull, 0x8080808007060400ull, 0x8080808007060401ull, 0x8080800706040100ull,
+    0x8080808007060402ull, 0x8080800706040200ull, 0x8080800706040201ull, 0x8080070604020100ull,
+    0x8080808007060403ull, 0x8080800706040300ull, 0x8080800706040301ull, 0x8080070604030100ull,
+    0x8080800706040302ull, 0x8080070604030200ull, 0x8080070604030201ull, 0x8007060403020100ull,
+    0x8080808080070605ull, 0x8080808007060500ull, 0x8080808007060501ull, 0x8080800706050100ull,
+    0x8080808007060502ull, 0x8080800706050200ull, 0x8080800706050201ull, 0x8080070605020100ull,
+    0x8080808007060503ull, 0x8080800706050300ull, 0x8080800706050301ull, 0x8080070605030100ull,
+    0x8080800706050302ull, 0x8080070605030200ull, 0x8080070605030201ull, 0x8007060503020100ull,
+    0x8080808007060504ull, 0x8080800706050400ull, 0x8080800706050401ull, 0x8080070605040100ull,
+    0x8080800706050402ull, 0x8080070605040200ull, 0x8080070605040201ull, 0x8007060504020100ull,
+    0x8080800706050403ull, 0x8080070605040300ull, 0x8080070605040301ull, 0x8007060504030100ull,
+    0x8080070605040302ull, 0x8007060504030200ull, 0x8007060504030201ull, 0x0706050403020100ull,
+};
+#endif
+
+#if defined(ASCII23_SIMD_SSE2)
+// Wrapper around SSE2 intrinsics, so that the same kernel templates
+// can be instantiated for both 16-byte and 32-byte vectors.
+// Table lookups are only available when SSSE3 is also enabled.
+struct simd_sse2 {
+    typedef __m128i vec;
+    static const size_t size = 16;
+    static const uint32_t all_bits = 0xffff;
+    static ASCII23_FORCE_INLINE vec load(const char* ptr) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    }
+    static ASCII23_FORCE_INLINE void store(char* ptr, const vec x) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), x);
+    }
+    static ASCII23_FORCE_INLINE vec zero() {
+        return _mm_setzero_si128();
+    }
+    static ASCII23_FORCE_INLINE vec set1(const int ch) {
+        return _mm_set1_epi8(static_cast<char>(ch));
+    }
+    static ASCII23_FORCE_INLINE vec eq(const vec a, const vec b) {
+        return _mm_cmpeq_epi8(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec and_(const vec a, const vec b) {
+        return _mm_and_si128(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec or_(const vec a, const vec b) {
+        return _mm_or_si128(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec xor_(const vec a, const vec b) {
+        return _mm_xor_si128(a, b);
+    }
+    // Bitwise `a & ~b`.
+    static ASCII23_FORCE_INLINE vec and_not(const vec a, const vec b) {
+        return _mm_andnot_si128(b, a);
+    }
+    static ASCII23_FORCE_INLINE vec add(const vec a, const vec b) {
+        return _mm_add_epi8(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec sub(const vec a, const vec b) {
+        return _mm_sub_epi8(a, b);
+    }
+    // Bytes with the high bit set, i.e. non-ASCII bytes, are set to 0xff.
+    static ASCII23_FORCE_INLINE vec high_bit(const vec x) {
+        return _mm_cmpgt_epi8(zero(), x);
+    }
+    // Sum of all bytes, treated as unsigned.
+    static ASCII23_FORCE_INLINE uint64_t sum_bytes(const vec x) {
+        uint64_t sums[2];
+        store(reinterpret_cast<char*>(sums), _mm_sad_epu8(x, zero()));
+        return sums[0] + sums[1];
+    }
+    // One bit per byte, set when the byte's high bit is set.
+    static ASCII23_FORCE_INLINE uint32_t mask(const vec x) {
+        return static_cast<uint32_t>(_mm_movemask_epi8(x));
+    }
+    // Bytes in the inclusive range `lo-hi` are set to 0xff, others to 0.
+    // Requires `0 <= lo <= hi <= 0x7f`.
+    static ASCII23_FORCE_INLINE vec in_range(
+        const vec x, const int lo, const int hi
+    ) {
+        // Bias so that an unsigned range check becomes one signed compare
+        const vec biased = _mm_add_epi8(x, set1(0x80 - lo));
+        return _mm_cmpgt_epi8(set1(hi - lo - 0x7f), biased);
+    }
+    // Each byte's high nibble, in the low nibble.
+    static ASCII23_FORCE_INLINE vec high_nibbles(const vec x) {
+        return and_(_mm_srli_epi16(x, 4), set1(0x0f));
+    }
+    // Store `2 * size` bytes, alternating between `a` and `b`.
+    static ASCII23_FORCE_INLINE void store_interleaved(
+        char* ptr, const vec a, const vec b
+    ) {
+        store(ptr, _mm_unpacklo_epi8(a, b));
+        store(ptr + size, _mm_unpackhi_epi8(a, b));
+    }
+    // Store `size / 2` bytes, each combining a pair of nibbles with
+    // the first of the pair in the high nibble.
+    static ASCII23_FORCE_INLINE void store_nibble_pairs(
+        char* ptr, const vec nibbles
+    ) {
+        const vec high = _mm_and_si128(
+            _mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0x00ff)
+        );
+        const vec bytes = or_(high, _mm_srli_epi16(nibbles, 8));
+        _mm_storel_epi64(
+            reinterpret_cast<__m128i*>(ptr), _mm_packus_epi16(bytes, bytes)
+        );
+    }
+    static ASCII23_FORCE_INLINE vec set1_u32(const uint32_t value) {
+        return _mm_set1_epi32(static_cast<int>(value));
+    }
+    // Unsigned byte subtraction, saturating at 0.
+    static ASCII23_FORCE_INLINE vec subs_u8(const vec a, const vec b) {
+        return _mm_subs_epu8(a, b);
+    }
+    // High and low halves of 16-bit products.
+    static ASCII23_FORCE_INLINE vec mulhi_u16(const vec a, const vec b) {
+        return _mm_mulhi_epu16(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec mullo_u16(const vec a, const vec b) {
+        return _mm_mullo_epi16(a, b);
+    }
+    // Multiply 16-bit values and add adjacent products into 32 bits.
+    static ASCII23_FORCE_INLINE vec multiply_add_i16(const vec a, const vec b) {
+        return _mm_madd_epi16(a, b);
+    }
+    // Load a 16-byte table, repeated in each 16-byte lane.
+    static ASCII23_FORCE_INLINE vec load_lane_table(const char* ptr) {
+        return load(ptr);
+    }
+    // Load `size / 4 * 3` bytes, as 12 bytes at the start of each lane.
+    // Reads `size` bytes.
+    static ASCII23_FORCE_INLINE vec load_triples(const char* ptr) {
+        return load(ptr);
+    }
+    // Store the 12 bytes at the start of each lane, `size / 4 * 3` bytes
+    // in total. Writes `size` bytes.
+    static ASCII23_FORCE_INLINE void store_triples(char* ptr, const vec x) {
+        store(ptr, x);
+    }
+    #if defined(ASCII23_SIMD_SSSE3)
+    // Multiply unsigned bytes of `a` by signed bytes of `b` and add
+    // adjacent products into 16 bits.
+    static ASCII23_FORCE_INLINE vec multiply_add_u8(const vec a, const vec b) {
+        return _mm_maddubs_epi16(a, b);
+    }
+    // Store the bytes of `x` selected by the bits of `keep`, in order.
+    // Returns the number stored. Writes up to `size` bytes.
+    static ASCII23_FORCE_INLINE size_t store_compacted(
+        char* ptr, const vec x, const uint32_t keep
+    ) {
+        const vec low = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(
+            &COMPACT_SHUFFLE_TABLE[keep & 0xff]
+        ));
+        const vec high = _mm_add_epi8(set1(8), _mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(&COMPACT_SHUFFLE_TABLE[(keep >> 8) & 0xff])
+        ));
+        const vec compacted = shuffle(x, _mm_unpacklo_epi64(low, high));
+        const size_t low_count = static_cast<size_t>(popcount(keep & 0xff));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), compacted);
+        _mm_storel_epi64(
+            reinterpret_cast<__m128i*>(ptr + low_count),
+            _mm_unpackhi_epi64(compacted, compacted)
+        );
+        return low_count + static_cast<size_t>(popcount((keep >> 8) & 0xff));
+    }
+    // Table lookup, indexed by the low nibble of each byte of `index`.
+    // Bytes of `index` with the high bit set produce 0.
+    static ASCII23_FORCE_INLINE vec shuffle(const vec table, const vec index) {
+        return _mm_shuffle_epi8(table, index);
+    }
+    // Table mapping nibbles 0-7 to a single set bit, and 8-f to 0.
+    static ASCII23_FORCE_INLINE vec high_nibble_bits() {
+        return _mm_setr_epi8(
+            1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0
+        );
+    }
+    static ASCII23_FORCE_INLINE vec load_char_set(const char_set set) {
+        return _mm_set_epi64x(
+            static_cast<long long>(set.high), static_cast<long long>(set.low)
+        );
+    }
+    #endif
+};
+#endif
+
+#if defined(ASCII23_SIMD_AVX2)
+// Same interface as `simd_sse2`, for AVX2 32-byte vectors.
+struct simd_avx2 {
+    typedef __m256i vec;
+    static const size_t size = 32;
+    static const uint32_t all_bits = 0xffffffff;
+    static ASCII23_FORCE_INLINE vec load(const char* ptr) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    }
+    static ASCII23_FORCE_INLINE void store(char* ptr, const vec x) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), x);
+    }
+    static ASCII23_FORCE_INLINE vec zero() {
+        return _mm256_setzero_si256();
+    }
+    static ASCII23_FORCE_INLINE vec set1(const int ch) {
+        return _mm256_set1_epi8(static_cast<char>(ch));
+    }
+    static ASCII23_FORCE_INLINE vec eq(const vec a, const vec b) {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec and_(const vec a, const vec b) {
+        return _mm256_and_si256(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec or_(const vec a, const vec b) {
+        return _mm256_or_si256(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec xor_(const vec a, const vec b) {
+        return _mm256_xor_si256(a, b);
+    }
+    // Bitwise `a & ~b`.
+    static ASCII23_FORCE_INLINE vec and_not(const vec a, const vec b) {
+        return _mm256_andnot_si256(b, a);
+    }
+    static ASCII23_FORCE_INLINE vec add(const vec a, const vec b) {
+        return _mm256_add_epi8(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec sub(const vec a, const vec b) {
+        return _mm256_sub_epi8(a, b);
+    }
+    // Bytes with the high bit set, i.e. non-ASCII bytes, are set to 0xff.
+    static ASCII23_FORCE_INLINE vec high_bit(const vec x) {
+        return _mm256_cmpgt_epi8(zero(), x);
+    }
+    // Sum of all bytes, treated as unsigned.
+    static ASCII23_FORCE_INLINE uint64_t sum_bytes(const vec x) {
+        uint64_t sums[4];
+        store(reinterpret_cast<char*>(sums), _mm256_sad_epu8(x, zero()));
+        return sums[0] + sums[1] + sums[2] + sums[3];
+    }
+    // One bit per byte, set when the byte's high bit is set.
+    static ASCII23_FORCE_INLINE uint32_t mask(const vec x) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(x));
+    }
+    static ASCII23_FORCE_INLINE vec in_range(
+        const vec x, const int lo, const int hi
+    ) {
+        const vec biased = _mm256_add_epi8(x, set1(0x80 - lo));
+        return _mm256_cmpgt_epi8(set1(hi - lo - 0x7f), biased);
+    }
+    static ASCII23_FORCE_INLINE vec high_nibbles(const vec x) {
+        return and_(_mm256_srli_epi16(x, 4), set1(0x0f));
+    }
+    // Unpacking is within each 16-byte lane, so lanes are reordered.
+    static ASCII23_FORCE_INLINE void store_interleaved(
+        char* ptr, const vec a, const vec b
+    ) {
+        const vec low = _mm256_unpacklo_epi8(a, b);
+        const vec high = _mm256_unpackhi_epi8(a, b);
+        store(ptr, _mm256_permute2x128_si256(low, high, 0x20));
+        store(ptr + size, _mm256_permute2x128_si256(low, high, 0x31));
+    }
+    static ASCII23_FORCE_INLINE void store_nibble_pairs(
+        char* ptr, const vec nibbles
+    ) {
+        const vec high = _mm256_and_si256(
+            _mm256_slli_epi16(nibbles, 4), _mm256_set1_epi16(0x00ff)
+        );
+        const vec bytes = or_(high, _mm256_srli_epi16(nibbles, 8));
+        const vec packed = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(bytes, bytes), 0x08
+        );
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(ptr), _mm256_castsi256_si128(packed)
+        );
+    }
+    static ASCII23_FORCE_INLINE vec set1_u32(const uint32_t value) {
+        return _mm256_set1_epi32(static_cast<int>(value));
+    }
+    static ASCII23_FORCE_INLINE vec subs_u8(const vec a, const vec b) {
+        return _mm256_subs_epu8(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec mulhi_u16(const vec a, const vec b) {
+        return _mm256_mulhi_epu16(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec mullo_u16(const vec a, const vec b) {
+        return _mm256_mullo_epi16(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec multiply_add_i16(const vec a, const vec b) {
+        return _mm256_madd_epi16(a, b);
+    }
+    static ASCII23_FORCE_INLINE vec multiply_add_u8(const vec a, const vec b) {
+        return _mm256_maddubs_epi16(a, b);
+    }
+    // Each 16-byte lane is compacted with `simd_sse2`.
+    static ASCII23_FORCE_INLINE size_t store_compacted(
+        char* ptr, const vec x, const uint32_t keep
+    ) {
+        const size_t low_count = simd_sse2::store_compacted(
+            ptr, _mm256_castsi256_si128(x), keep & 0xffff
+        );
+        return low_count + simd_sse2::store_compacted(
+            ptr + low_count, _mm256_extracti128_si256(x, 1), keep >> 16
+        );
+    }
+    static ASCII23_FORCE_INLINE vec load_lane_table(const char* ptr) {
+        return _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr))
+        );
+    }
+    // Reads 28 bytes, as two overlapping 16-byte loads.
+    static ASCII23_FORCE_INLINE vec load_triples(const char* ptr) {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr))
+        ), _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 12)), 1);
+    }
+    static ASCII23_FORCE_INLINE void store_triples(char* ptr, const vec x) {
+        store(ptr, _mm256_permutevar8x32_epi32(
+            x, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)
+        ));
+    }
+    // Lookups are within each 16-byte lane, so tables are repeated.
+    static ASCII23_FORCE_INLINE vec shuffle(const vec table, const vec index) {
+        return _mm256_shuffle_epi8(table, index);
+    }
+    static ASCII23_FORCE_INLINE vec high_nibble_bits() {
+        return _mm256_setr_epi8(
+            1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+            1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0
+        );
+    }
+    static ASCII23_FORCE_INLINE vec load_char_set(const char_set set) {
+        return _mm256_set_epi64x(
+            static_cast<long long>(set.high), static_cast<long long>(set.low),
+            static_cast<long long>(set.high), static_cast<long long>(set.low)
+        );
+    }
+};
+#endif
+
+// Flip the 0x20 case bit of every byte in the range `lo-hi`.
+// Returns the number of bytes processed, a multiple of the vector size.
+template<typename simd>
+inline size_t simd_flip_case(
+    const char* src, const size_t length, char* dst,
+    const int lo, const int hi
+) {
+    typedef typename simd::vec vec;
+    const vec case_bit = simd::set1(0x20);
+    size_t i = 0;
+    for(; i + simd::size <= length; i += simd::size) {
+        const vec x = simd::load(src + i);
+        const vec flip = simd::and_(simd::in_range(x, lo, hi), case_bit);
+        simd::store(dst + i, simd::xor_(x, flip));
+    }
+    return i;
+}
+
+} // namespace detail
+
+ASCII23_INLINE void to_lower(char* str, const size_t length) {
+    to_lower(str, length, str);
+}
+
+ASCII23_INLINE void to_lower(const char* src, const size_t length, char* dst) {
+    size_t i = 0;
+    #if defined(ASCII23_SIMD_AVX2)
+    i += detail::simd_flip_case<detail::simd_avx2>(
+        src + i, length - i, dst + i, 'A', 'Z'
+    );
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    i += detail::simd_flip_case<detail::simd_sse2>(
+        src + i, length - i, dst + i, 'A', 'Z'
+    );
+    #endif
+    for(; i < length; ++i) {
+        dst[i] = static_cast<char>(
+            to_lower_char(static_cast<unsigned char>(src[i]))
+        );
+    }
+}
+
+ASCII23_INLINE void to_upper(char* str, const size_t length) {
+    to_upper(str, length, str);
+}
+
+ASCII23_INLINE void to_upper(const char* src, const size_t length, char* dst) {
+    size_t i = 0;
+    #if defined(ASCII23_SIMD_AVX2)
+    i += detail::simd_flip_case<detail::simd_avx2>(
+        src + i, length - i, dst + i, 'a', 'z'
+    );
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    i += detail::simd_flip_case<detail::simd_sse2>(
+        src + i, length - i, dst + i, 'a', 'z'
+    );
+    #endif
+    for(; i < length; ++i) {
+        dst[i] = static_cast<char>(
+            to_upper_char(static_cast<unsigned char>(src[i]))
+        );
+    }
+}
+
+namespace detail {
+
+// Skip ahead while no byte has its high bit set, checking four vectors
+// per step. Returns the number of bytes skipped, which may be less than
+// the length of the ASCII prefix.
+template<typename simd>
+inline size_t simd_ascii_prefix_length(const char* str, const size_t length) {
+    typedef typename simd::vec vec;
+    size_t i = 0;
+    for(; i + 4 * simd::size <= length; i += 4 * simd::size) {
+        const vec a = simd::load(str + i);
+        const vec b = simd::load(str + i + simd::size);
+        const vec c = simd::load(str + i + 2 * simd::size);
+        const vec d = simd::load(str + i + 3 * simd::size);
+        if(simd::mask(simd::or_(simd::or_(a, b), simd::or_(c, d)))) {
+            break;
+        }
+    }
+    for(; i + simd::size <= length; i += simd::size) {
+        const uint32_t high_bits = simd::mask(simd::load(str + i));
+        if(high_bits) {
+            return i + count_trailing_zeros(high_bits);
+        }
+    }
+    return i;
+}
+
+// Same as `simd_ascii_prefix_length`, eight bytes at a time.
+inline size_t swar_ascii_prefix_length(const char* str, const size_t length) {
+    size_t i = 0;
+    for(; i + 8 <= length; i += 8) {
+        if(load_u64(str + i) & SWAR_HIGH_BITS) {
+            break;
+        }
+    }
+    return i;
+}
+
+} // namespace detail
+
+ASCII23_INLINE bool is_all_ascii(const char* str, const size_t length) {
+    return ascii_prefix_length(str, length) == length;
+}
+
+ASCII23_INLINE size_t ascii_prefix_length(const char* str, const size_t length) {
+    size_t i = 0;
+    #if defined(ASCII23_SIMD_AVX2)
+    i += detail::simd_ascii_prefix_length<detail::simd_avx2>(str, length);
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    i += detail::simd_ascii_prefix_length<detail::simd_sse2>(
+        str + i, length - i
+    );
+    #endif
+    i += detail::swar_ascii_prefix_length(str + i, length - i);
+    while(i < length && is_char(static_cast<unsigned char>(str[i]))) {
+        ++i;
+    }
+    return i;
+}
+
+namespace detail {
+
+// True when a byte is ASCII and has any of the given flags.
+ASCII23_FORCE_INLINE bool has_flags(const char ch, const int flags) {
+    const unsigned char uch = static_cast<unsigned char>(ch);
+    return uch <= 0x7f && (char_flags_array[uch] & flags);
+}
+
+// Vectorized equivalent of `has_flags`: Bytes having any of the given
+// flags are set to 0xff, others to 0. When inlined with constant flags,
+// the tests for flags that aren't requested are optimized away.
+template<typename simd>
+ASCII23_FORCE_INLINE typename simd::vec simd_flags_mask(
+    const typename simd::vec x, const int flags
+) {
+    typedef typename simd::vec vec;
+    vec result = simd::zero();
+    if(flags & (
+        CHAR_FLAG_ALPHA | CHAR_FLAG_HEX_DIGIT | CHAR_FLAG_WORD |
+        CHAR_FLAG_WORD_START | CHAR_FLAG_PUNCTUATION
+    )) {
+        // Setting the 0x20 bit maps A-Z onto a-z and nothing else onto a-z
+        const vec folded = simd::or_(x, simd::set1(0x20));
+        const vec alpha = simd::in_range(folded, 'a', 'z');
+        const vec digit = simd::in_range(x, '0', '9');
+        const vec underscore = simd::eq(x, simd::set1('_'));
+        if(flags & CHAR_FLAG_ALPHA) {
+            result = simd::or_(result, alpha);
+        }
+        if(flags & CHAR_FLAG_HEX_DIGIT) {
+            result = simd::or_(result, digit);
+            result = simd::or_(result, simd::in_range(folded, 'a', 'f'));
+        }
+        if(flags & CHAR_FLAG_WORD) {
+            result = simd::or_(result, simd::or_(alpha, digit));
+            result = simd::or_(result, underscore);
+        }
+        if(flags & CHAR_FLAG_WORD_START) {
+            result = simd::or_(result, simd::or_(alpha, underscore));
+        }
+        if(flags & CHAR_FLAG_PUNCTUATION) {
+            result = simd::or_(result, simd::and_not(
+                simd::in_range(x, 0x21, 0x7e), simd::or_(alpha, digit)
+            ));
+        }
+    }
+    if(flags & CHAR_FLAG_LOWER) {
+        result = simd::or_(result, simd::in_range(x, 'a', 'z'));
+    }
+    if(flags & CHAR_FLAG_UPPER) {
+        result = simd::or_(result, simd::in_range(x, 'A', 'Z'));
+    }
+    if(flags & CHAR_FLAG_DIGIT) {
+        result = simd::or_(result, simd::in_range(x, '0', '9'));
+    }
+    if(flags & (CHAR_FLAG_WHITESPACE | CHAR_FLAG_BLANK)) {
+        const vec space = simd::eq(x, simd::set1(' '));
+        if(flags & CHAR_FLAG_WHITESPACE) {
+            result = simd::or_(result, space);
+            result = simd::or_(result, simd::in_range(x, '\t', '\r'));
+        }
+        if(flags & CHAR_FLAG_BLANK) {
+            result = simd::or_(result, space);
+            result = simd::or_(result, simd::eq(x, simd::set1('\t')));
+        }
+    }
+    if(flags & CHAR_FLAG_CONTROL) {
+        result = simd::or_(result, simd::in_range(x, 0x00, 0x1f));
+        result = simd::or_(result, simd::eq(x, simd::set1(0x7f)));
+    }
+    if(flags & CHAR_FLAG_PRINTABLE) {
+        result = simd::or_(result, simd::in_range(x, 0x20, 0x7e));
+    }
+    if(flags & CHAR_FLAG_GRAPHICAL) {
+        result = simd::or_(result, simd::in_range(x, 0x21, 0x7e));
+    }
+    return result;
+}
+
+// Classifies the bytes of a vector using `simd_flags_mask`.
+template<typename simd>
+struct simd_flags_classifier {
+    const int flags;
+    explicit simd_flags_classifier(const int match_flags) : flags(match_flags) {}
+    ASCII23_FORCE_INLINE typename simd::vec operator()(
+        const typename simd::vec x
+    ) const {
+        return simd_flags_mask<simd>(x, flags);
+    }
+};
+
+// Classifies single bytes using `has_flags`.
+struct flags_classifier {
+    const int flags;
+    explicit flags_classifier(const int match_flags) : flags(match_flags) {}
+    ASCII23_FORCE_INLINE bool operator()(const char ch) const {
+        return has_flags(ch, flags);
+    }
+};
+
+// One bit per byte of a vector, set for bytes matched by a classifier,
+// or for bytes not matched by it when `invert` is true.
+template<typename simd, bool invert, typename classifier>
+ASCII23_FORCE_INLINE uint32_t simd_bits(
+    const char* ptr, const classifier& classify
+) {
+    const uint32_t bits = simd::mask(classify(simd::load(ptr)));
+    return invert ? (~bits & simd::all_bits) : bits;
+}
+
+// Requires `length >= simd::size`. The tail is handled by re-reading
+// the last full vector, ignoring bytes that were already checked.
+template<typename simd, bool invert, typename classifier>
+inline size_t simd_find_first(
+    const char* str, const size_t length, const classifier& classify
+) {
+    size_t i = 0;
+    for(; i + simd::size <= length; i += simd::size) {
+        const uint32_t bits = simd_bits<simd, invert>(str + i, classify);
+        if(bits) {
+            return i + count_trailing_zeros(bits);
+        }
+    }
+    if(i < length) {
+        const size_t last = length - simd::size;
+        const uint32_t bits = (
+            simd_bits<simd, invert>(str + last, classify) >> (i - last)
+        );
+        if(bits) {
+            return i + count_trailing_zeros(bits);
+        }
+    }
+    return npos;
+}
+
+// Requires `length >= simd::size`. The head is handled by re-reading
+// the first full vector, ignoring bytes that were already checked.
+template<typename simd, bool invert, typename classifier>
+inline size_t simd_find_last(
+    const char* str, const size_t length, const classifier& classify
+) {
+    size_t i = length;
+    for(; i >= simd::size; i -= simd::size) {
+        const size_t start = i - simd::size;
+        const uint32_t bits = simd_bits<simd, invert>(str + start, classify);
+        if(bits) {
+            return start + highest_bit_index(bits);
+        }
+    }
+    if(i > 0) {
+        const uint32_t bits = (
+            simd_bits<simd, invert>(str, classify) &
+            ((static_cast<uint32_t>(1) << i) - 1)
+        );
+        if(bits) {
+            return highest_bit_index(bits);
+        }
+    }
+    return npos;
+}
+
+template<bool invert, typename classifier>
+inline size_t scalar_find_first(
+    const char* str, const size_t length, const classifier& classify
+) {
+    for(size_t i = 0; i < length; ++i) {
+        if(classify(str[i]) != invert) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+template<bool invert, typename classifier>
+inline size_t scalar_find_last(
+    const char* str, const size_t length, const classifier& classify
+) {
+    for(size_t i = length; i > 0; --i) {
+        if(classify(str[i - 1]) != invert) {
+            return i - 1;
+        }
+    }
+    return npos;
+}
+
+template<bool invert>
+ASCII23_FORCE_INLINE size_t find_first_flags(
+    const char* str, const size_t length, const int flags
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(length >= simd_avx2::size) {
+        return simd_find_first<simd_avx2, invert>(
+            str, length, simd_flags_classifier<simd_avx2>(flags)
+        );
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    if(length >= simd_sse2::size) {
+        return simd_find_first<simd_sse2, invert>(
+            str, length, simd_flags_classifier<simd_sse2>(flags)
+        );
+    }
+    #endif
+    return scalar_find_first<invert>(str, length, flags_classifier(flags));
+}
+
+template<bool invert>
+ASCII23_FORCE_INLINE size_t find_last_flags(
+    const char* str, const size_t length, const int flags
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(length >= simd_avx2::size) {
+        return simd_find_last<simd_avx2, invert>(
+            str, length, simd_flags_classifier<simd_avx2>(flags)
+        );
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    if(length >= simd_sse2::size) {
+        return simd_find_last<simd_sse2, invert>(
+            str, length, simd_flags_classifier<simd_sse2>(flags)
+        );
+    }
+    #endif
+    return scalar_find_last<invert>(str, length, flags_classifier(flags));
+}
+
+} // namespace detail
+
+ASCII23_INLINE size_t find_first_flags(const char* str, const size_t length, const int flags) {
+    return detail::find_first_flags<false>(str, length, flags);
+}
+
+ASCII23_INLINE size_t find_first_not_flags(const char* str, const size_t length, const int flags) {
+    return detail::find_first_flags<true>(str, length, flags);
+}
+
+ASCII23_INLINE size_t find_last_flags(const char* str, const size_t length, const int flags) {
+    return detail::find_last_flags<false>(str, length, flags);
+}
+
+ASCII23_INLINE size_t find_last_not_flags(const char* str, const size_t length, const int flags) {
+    return detail::find_last_flags<true>(str, length, flags);
+}
+
+ASCII23_INLINE size_t find_first_alpha(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_ALPHA);
+}
+
+ASCII23_INLINE size_t find_first_not_alpha(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_ALPHA);
+}
+
+ASCII23_INLINE size_t find_last_alpha(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_ALPHA);
+}
+
+ASCII23_INLINE size_t find_last_not_alpha(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_ALPHA);
+}
+
+ASCII23_INLINE size_t find_first_alpha_lower(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_LOWER);
+}
+
+ASCII23_INLINE size_t find_first_not_alpha_lower(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_LOWER);
+}
+
+ASCII23_INLINE size_t find_last_alpha_lower(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_LOWER);
+}
+
+ASCII23_INLINE size_t find_last_not_alpha_lower(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_LOWER);
+}
+
+ASCII23_INLINE size_t find_first_alpha_upper(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_UPPER);
+}
+
+ASCII23_INLINE size_t find_first_not_alpha_upper(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_UPPER);
+}
+
+ASCII23_INLINE size_t find_last_alpha_upper(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_UPPER);
+}
+
+ASCII23_INLINE size_t find_last_not_alpha_upper(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_UPPER);
+}
+
+ASCII23_INLINE size_t find_first_digit(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_DIGIT);
+}
+
+ASCII23_INLINE size_t find_first_not_digit(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_DIGIT);
+}
+
+ASCII23_INLINE size_t find_last_digit(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_DIGIT);
+}
+
+ASCII23_INLINE size_t find_last_not_digit(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_DIGIT);
+}
+
+ASCII23_INLINE size_t find_first_hex_digit(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_HEX_DIGIT);
+}
+
+ASCII23_INLINE size_t find_first_not_hex_digit(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_HEX_DIGIT);
+}
+
+ASCII23_INLINE size_t find_last_hex_digit(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_HEX_DIGIT);
+}
+
+ASCII23_INLINE size_t find_last_not_hex_digit(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_HEX_DIGIT);
+}
+
+ASCII23_INLINE size_t find_first_word(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_WORD);
+}
+
+ASCII23_INLINE size_t find_first_not_word(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_WORD);
+}
+
+ASCII23_INLINE size_t find_last_word(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_WORD);
+}
+
+ASCII23_INLINE size_t find_last_not_word(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_WORD);
+}
+
+ASCII23_INLINE size_t find_first_word_start(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_WORD_START);
+}
+
+ASCII23_INLINE size_t find_first_not_word_start(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_WORD_START);
+}
+
+ASCII23_INLINE size_t find_last_word_start(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_WORD_START);
+}
+
+ASCII23_INLINE size_t find_last_not_word_start(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_WORD_START);
+}
+
+ASCII23_INLINE size_t find_first_punctuation(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_PUNCTUATION);
+}
+
+ASCII23_INLINE size_t find_first_not_punctuation(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_PUNCTUATION);
+}
+
+ASCII23_INLINE size_t find_last_punctuation(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_PUNCTUATION);
+}
+
+ASCII23_INLINE size_t find_last_not_punctuation(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_PUNCTUATION);
+}
+
+ASCII23_INLINE size_t find_first_whitespace(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_WHITESPACE);
+}
+
+ASCII23_INLINE size_t find_first_not_whitespace(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_WHITESPACE);
+}
+
+ASCII23_INLINE size_t find_last_whitespace(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_WHITESPACE);
+}
+
+ASCII23_INLINE size_t find_last_not_whitespace(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_WHITESPACE);
+}
+
+ASCII23_INLINE size_t find_first_blank(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_BLANK);
+}
+
+ASCII23_INLINE size_t find_first_not_blank(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_BLANK);
+}
+
+ASCII23_INLINE size_t find_last_blank(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_BLANK);
+}
+
+ASCII23_INLINE size_t find_last_not_blank(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_BLANK);
+}
+
+ASCII23_INLINE size_t find_first_control(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_CONTROL);
+}
+
+ASCII23_INLINE size_t find_first_not_control(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_CONTROL);
+}
+
+ASCII23_INLINE size_t find_last_control(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_CONTROL);
+}
+
+ASCII23_INLINE size_t find_last_not_control(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_CONTROL);
+}
+
+ASCII23_INLINE size_t find_first_printable(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_PRINTABLE);
+}
+
+ASCII23_INLINE size_t find_first_not_printable(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_PRINTABLE);
+}
+
+ASCII23_INLINE size_t find_last_printable(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_PRINTABLE);
+}
+
+ASCII23_INLINE size_t find_last_not_printable(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_PRINTABLE);
+}
+
+ASCII23_INLINE size_t find_first_graphical(const char* str, const size_t length) {
+    return detail::find_first_flags<false>(str, length, CHAR_FLAG_GRAPHICAL);
+}
+
+ASCII23_INLINE size_t find_first_not_graphical(const char* str, const size_t length) {
+    return detail::find_first_flags<true>(str, length, CHAR_FLAG_GRAPHICAL);
+}
+
+ASCII23_INLINE size_t find_last_graphical(const char* str, const size_t length) {
+    return detail::find_last_flags<false>(str, length, CHAR_FLAG_GRAPHICAL);
+}
+
+ASCII23_INLINE size_t find_last_not_graphical(const char* str, const size_t length) {
+    return detail::find_last_flags<true>(str, length, CHAR_FLAG_GRAPHICAL);
+}
+
+namespace detail {
+
+// Disjoint byte categories, from which the count for every character
+// class can be derived. The classes overlap heavily, so this needs fewer
+// accumulators than counting each class separately.
+enum char_category {
+    CHAR_CATEGORY_LOWER, // a-z
+    CHAR_CATEGORY_UPPER, // A-Z
+    CHAR_CATEGORY_DIGIT, // 0-9
+    CHAR_CATEGORY_HEX_ALPHA, // a-f, A-F
+    CHAR_CATEGORY_UNDERSCORE,
+    CHAR_CATEGORY_GRAPHICAL, // 0x21-0x7e
+    CHAR_CATEGORY_SPACE,
+    CHAR_CATEGORY_TAB,
+    CHAR_CATEGORY_WHITESPACE_CONTROL, // \t, \r, \v, \f, \n
+    CHAR_CATEGORY_NON_ASCII,
+    CHAR_CATEGORY_COUNT,
+};
+
+// Add one byte to the category totals.
+ASCII23_FORCE_INLINE void count_categories(const char ch, uint64_t* totals) {
+    const int uch = static_cast<unsigned char>(ch);
+    totals[CHAR_CATEGORY_LOWER] += is_alpha_lower_char(uch);
+    totals[CHAR_CATEGORY_UPPER] += is_alpha_upper_char(uch);
+    totals[CHAR_CATEGORY_DIGIT] += is_digit_char(uch);
+    totals[CHAR_CATEGORY_HEX_ALPHA] += (
+        is_hex_digit_char(uch) && !is_digit_char(uch)
+    );
+    totals[CHAR_CATEGORY_UNDERSCORE] += uch == '_';
+    totals[CHAR_CATEGORY_GRAPHICAL] += is_graphical_char(uch);
+    totals[CHAR_CATEGORY_SPACE] += uch == ' ';
+    totals[CHAR_CATEGORY_TAB] += uch == '\t';
+    totals[CHAR_CATEGORY_WHITESPACE_CONTROL] += uch >= '\t' && uch <= '\r';
+    totals[CHAR_CATEGORY_NON_ASCII] += uch > 0x7f;
+}
+
+// Per-byte category masks of a vector, where 0xff means the byte
+// belongs to the category, in the same order as `char_category`.
+template<typename simd>
+ASCII23_FORCE_INLINE void simd_categories(
+    const typename simd::vec x, typename simd::vec* categories
+) {
+    typedef typename simd::vec vec;
+    const vec folded = simd::or_(x, simd::set1(0x20));
+    categories[CHAR_CATEGORY_LOWER] = simd::in_range(x, 'a', 'z');
+    categories[CHAR_CATEGORY_UPPER] = simd::in_range(x, 'A', 'Z');
+    categories[CHAR_CATEGORY_DIGIT] = simd::in_range(x, '0', '9');
+    categories[CHAR_CATEGORY_HEX_ALPHA] = simd::in_range(folded, 'a', 'f');
+    categories[CHAR_CATEGORY_UNDERSCORE] = simd::eq(x, simd::set1('_'));
+    categories[CHAR_CATEGORY_GRAPHICAL] = simd::in_range(x, 0x21, 0x7e);
+    categories[CHAR_CATEGORY_SPACE] = simd::eq(x, simd::set1(' '));
+    categories[CHAR_CATEGORY_TAB] = simd::eq(x, simd::set1('\t'));
+    categories[CHAR_CATEGORY_WHITESPACE_CONTROL] = (
+        simd::in_range(x, '\t', '\r')
+    );
+    categories[CHAR_CATEGORY_NON_ASCII] = simd::high_bit(x);
+}
+
+// Add per-byte category masks (0xff means "count this byte") to byte
+// lane counters. Each call adds at most 1 to each lane.
+template<typename simd>
+ASCII23_FORCE_INLINE void simd_count_categories(
+    const typename simd::vec x, typename simd::vec* counters
+) {
+    typename simd::vec categories[CHAR_CATEGORY_COUNT];
+    simd_categories<simd>(x, categories);
+    for(size_t k = 0; k < CHAR_CATEGORY_COUNT; ++k) {
+        // Subtracting 0xff (i.e. -1) adds one
+        counters[k] = simd::sub(counters[k], categories[k]);
+    }
+}
+
+// Count categories for all full vectors, flushing the byte lane counters
+// into 64-bit totals before they can overflow.
+// Returns the number of bytes processed.
+template<typename simd>
+inline size_t simd_count_categories_all(
+    const char* str, const size_t length, uint64_t* totals
+) {
+    typedef typename simd::vec vec;
+    size_t i = 0;
+    while(i + simd::size <= length) {
+        vec counters[CHAR_CATEGORY_COUNT];
+        for(size_t k = 0; k < CHAR_CATEGORY_COUNT; ++k) {
+            counters[k] = simd::zero();
+        }
+        for(size_t n = 0; n < 0xff && i + simd::size <= length; ++n) {
+            simd_count_categories<simd>(simd::load(str + i), counters);
+            i += simd::size;
+        }
+        for(size_t k = 0; k < CHAR_CATEGORY_COUNT; ++k) {
+            totals[k] += simd::sum_bytes(counters[k]);
+        }
+    }
+    return i;
+}
+
+} // namespace detail
+
+ASCII23_INLINE char_class_histogram class_histogram(const char* str, const size_t length) {
+    uint64_t totals[detail::CHAR_CATEGORY_COUNT] = {};
+    size_t i = 0;
+    #if defined(ASCII23_SIMD_AVX2)
+    i += detail::simd_count_categories_all<detail::simd_avx2>(
+        str + i, length - i, totals
+    );
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    i += detail::simd_count_categories_all<detail::simd_sse2>(
+        str + i, length - i, totals
+    );
+    #endif
+    for(; i < length; ++i) {
+        detail::count_categories(str[i], totals);
+    }
+    const uint64_t lower = totals[detail::CHAR_CATEGORY_LOWER];
+    const uint64_t upper = totals[detail::CHAR_CATEGORY_UPPER];
+    const uint64_t digit = totals[detail::CHAR_CATEGORY_DIGIT];
+    const uint64_t underscore = totals[detail::CHAR_CATEGORY_UNDERSCORE];
+    const uint64_t graphical = totals[detail::CHAR_CATEGORY_GRAPHICAL];
+    const uint64_t space = totals[detail::CHAR_CATEGORY_SPACE];
+    const uint64_t non_ascii = totals[detail::CHAR_CATEGORY_NON_ASCII];
+    char_class_histogram histogram;
+    histogram.alpha = lower + upper;
+    histogram.lower = lower;
+    histogram.upper = upper;
+    histogram.digit = digit;
+    histogram.hex_digit = digit + totals[detail::CHAR_CATEGORY_HEX_ALPHA];
+    histogram.word = histogram.alpha + digit + underscore;
+    histogram.word_start = histogram.alpha + underscore;
+    histogram.punctuation = graphical - histogram.alpha - digit;
+    histogram.whitespace = (
+        space + totals[detail::CHAR_CATEGORY_WHITESPACE_CONTROL]
+    );
+    histogram.blank = space + totals[detail::CHAR_CATEGORY_TAB];
+    histogram.printable = graphical + space;
+    histogram.control = length - non_ascii - histogram.printable;
+    histogram.graphical = graphical;
+    histogram.non_ascii = non_ascii;
+    return histogram;
+}
+
+namespace detail {
+
+// Scalar reference for `classify_block_flags`.
+inline uint64_t scalar_block_flags_bits(const char* block, const int flags) {
+    uint64_t bits = 0;
+    for(size_t i = 0; i < CLASSIFY_BLOCK_SIZE; ++i) {
+        bits |= static_cast<uint64_t>(has_flags(block[i], flags)) << i;
+    }
+    return bits;
+}
+
+// Vectorized `classify_block_flags`. The vector size must divide 64.
+template<typename simd>
+ASCII23_FORCE_INLINE uint64_t simd_block_flags_bits(
+    const char* block, const int flags
+) {
+    uint64_t bits = 0;
+    for(size_t i = 0; i < CLASSIFY_BLOCK_SIZE; i += simd::size) {
+        bits |= static_cast<uint64_t>(simd_bits<simd, false>(
+            block + i, simd_flags_classifier<simd>(flags)
+        )) << i;
+    }
+    return bits;
+}
+
+ASCII23_FORCE_INLINE uint64_t block_bits(const char* block, const int flags) {
+    #if defined(ASCII23_SIMD_AVX2)
+    return simd_block_flags_bits<simd_avx2>(block, flags);
+    #elif defined(ASCII23_SIMD_SSE2)
+    return simd_block_flags_bits<simd_sse2>(block, flags);
+    #else
+    return scalar_block_flags_bits(block, flags);
+    #endif
+}
+
+// Masks of the bytes of a block in each `char_category`, from which
+// the mask for every character class can be derived.
+inline void scalar_block_categories(const char* block, uint64_t* masks) {
+    for(size_t i = 0; i < CLASSIFY_BLOCK_SIZE; ++i) {
+        uint64_t counts[CHAR_CATEGORY_COUNT] = {};
+        count_categories(block[i], counts);
+        for(size_t k = 0; k < CHAR_CATEGORY_COUNT; ++k) {
+            masks[k] |= counts[k] << i;
+        }
+    }
+}
+
+// Vectorized `scalar_block_categories`. The vector size must divide 64.
+// Each vector is loaded and classified once.
+template<typename simd>
+ASCII23_FORCE_INLINE void simd_block_categories(
+    const char* block, uint64_t* masks
+) {
+    for(size_t i = 0; i < CLASSIFY_BLOCK_SIZE; i += simd::size) {
+        typename simd::vec categories[CHAR_CATEGORY_COUNT];
+        simd_categories<simd>(simd::load(block + i), categories);
+        for(size_t k = 0; k < CHAR_CATEGORY_COUNT; ++k) {
+            masks[k] |= static_cast<uint64_t>(simd::mask(categories[k])) << i;
+        }
+    }
+}
+
+// Keeps the mask for a flag only if it was requested.
+ASCII23_FORCE_INLINE uint64_t requested_mask(
+    const uint64_t mask, const int flags, const int flag
+) {
+    return (flags & flag) ? mask : 0;
+}
+
+} // namespace detail
+
+ASCII23_INLINE char_block_masks classify_block(const char* block, const int flags) {
+    using detail::requested_mask;
+    uint64_t categories[detail::CHAR_CATEGORY_COUNT] = {};
+    #if defined(ASCII23_SIMD_AVX2)
+    detail::simd_block_categories<detail::simd_avx2>(block, categories);
+    #elif defined(ASCII23_SIMD_SSE2)
+    detail::simd_block_categories<detail::simd_sse2>(block, categories);
+    #else
+    detail::scalar_block_categories(block, categories);
+    #endif
+    // Class masks are combined the same way as `class_histogram` counts
+    const uint64_t lower = categories[detail::CHAR_CATEGORY_LOWER];
+    const uint64_t upper = categories[detail::CHAR_CATEGORY_UPPER];
+    const uint64_t digit = categories[detail::CHAR_CATEGORY_DIGIT];
+    const uint64_t underscore = categories[detail::CHAR_CATEGORY_UNDERSCORE];
+    const uint64_t graphical = categories[detail::CHAR_CATEGORY_GRAPHICAL];
+    const uint64_t space = categories[detail::CHAR_CATEGORY_SPACE];
+    const uint64_t non_ascii = categories[detail::CHAR_CATEGORY_NON_ASCII];
+    const uint64_t alpha = lower | upper;
+    char_block_masks masks;
+    masks.alpha = requested_mask(alpha, flags, CHAR_FLAG_ALPHA);
+    masks.lower = requested_mask(lower, flags, CHAR_FLAG_LOWER);
+    masks.upper = requested_mask(upper, flags, CHAR_FLAG_UPPER);
+    masks.digit = requested_mask(digit, flags, CHAR_FLAG_DIGIT);
+    masks.hex_digit = requested_mask(
+        digit | categories[detail::CHAR_CATEGORY_HEX_ALPHA],
+        flags, CHAR_FLAG_HEX_DIGIT
+    );
+    masks.word = requested_mask(
+        alpha | digit | underscore, flags, CHAR_FLAG_WORD
+    );
+    masks.word_start = requested_mask(
+        alpha | underscore, flags, CHAR_FLAG_WORD_START
+    );
+    masks.punctuation = requested_mask(
+        graphical & ~(alpha | digit), flags, CHAR_FLAG_PUNCTUATION
+    );
+    masks.whitespace = requested_mask(
+        space | categories[detail::CHAR_CATEGORY_WHITESPACE_CONTROL],
+        flags, CHAR_FLAG_WHITESPACE
+    );
+    masks.blank = requested_mask(
+        space | categories[detail::CHAR_CATEGORY_TAB], flags, CHAR_FLAG_BLANK
+    );
+    masks.control = requested_mask(
+        ~(graphical | space | non_ascii), flags, CHAR_FLAG_CONTROL
+    );
+    masks.printable = requested_mask(
+        graphical | space, flags, CHAR_FLAG_PRINTABLE
+    );
+    masks.graphical = requested_mask(graphical, flags, CHAR_FLAG_GRAPHICAL);
+    masks.non_ascii = non_ascii;
+    return masks;
+}
+
+ASCII23_INLINE uint64_t classify_block_flags(const char* block, const int flags) {
+    return detail::block_bits(block, flags);
+}
+
+namespace detail {
+
+#if defined(ASCII23_SIMD_SSSE3)
+// Classifies the bytes of a vector by membership in a `char_set`.
+// The set's bitmap is used as a table indexed by the low nibble of each
+// byte, giving a byte whose bits represent the possible high nibbles.
+template<typename simd>
+struct simd_char_set_classifier {
+    typedef typename simd::vec vec;
+    const vec table;
+    explicit simd_char_set_classifier(const char_set set) :
+        table(simd::load_char_set(set)) {}
+    ASCII23_FORCE_INLINE vec operator()(const vec x) const {
+        const vec rows = simd::shuffle(table, simd::and_(x, simd::set1(0x0f)));
+        // The bit for each byte's high nibble, or 0 for non-ASCII bytes
+        const vec columns = simd::shuffle(
+            simd::high_nibble_bits(), simd::high_nibbles(x)
+        );
+        const vec absent = simd::eq(simd::and_(rows, columns), simd::zero());
+        return simd::xor_(absent, simd::set1(0xff));
+    }
+};
+#endif
+
+// Classifies single bytes by membership in a `char_set`.
+struct char_set_classifier {
+    const char_set set;
+    explicit char_set_classifier(const char_set match_set) : set(match_set) {}
+    ASCII23_FORCE_INLINE bool operator()(const char ch) const {
+        return set.contains(static_cast<unsigned char>(ch));
+    }
+};
+
+template<bool invert>
+ASCII23_FORCE_INLINE size_t find_first_in(
+    const char* str, const size_t length, const char_set set
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(length >= simd_avx2::size) {
+        return simd_find_first<simd_avx2, invert>(
+            str, length, simd_char_set_classifier<simd_avx2>(set)
+        );
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSSE3)
+    if(length >= simd_sse2::size) {
+        return simd_find_first<simd_sse2, invert>(
+            str, length, simd_char_set_classifier<simd_sse2>(set)
+        );
+    }
+    #endif
+    return scalar_find_first<invert>(str, length, char_set_classifier(set));
+}
+
+template<bool invert>
+ASCII23_FORCE_INLINE size_t find_last_in(
+    const char* str, const size_t length, const char_set set
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(length >= simd_avx2::size) {
+        return simd_find_last<simd_avx2, invert>(
+            str, length, simd_char_set_classifier<simd_avx2>(set)
+        );
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSSE3)
+    if(length >= simd_sse2::size) {
+        return simd_find_last<simd_sse2, invert>(
+            str, length, simd_char_set_classifier<simd_sse2>(set)
+        );
+    }
+    #endif
+    return scalar_find_last<invert>(str, length, char_set_classifier(set));
+}
+
+} // namespace detail
+
+ASCII23_INLINE char_set char_set_from_flags(const int flags) {
+    char_set set;
+    for(int ch = 0; ch <= 0x7f; ++ch) {
+        if(char_flags_array[ch] & flags) {
+            set = set | char_set::range(ch, ch);
+        }
+    }
+    return set;
+}
+
+ASCII23_INLINE size_t find_first_in(const char* str, const size_t length, const char_set set) {
+    return detail::find_first_in<false>(str, length, set);
+}
+
+ASCII23_INLINE size_t find_first_not_in(const char* str, const size_t length, const char_set set) {
+    return detail::find_first_in<true>(str, length, set);
+}
+
+ASCII23_INLINE size_t find_last_in(const char* str, const size_t length, const char_set set) {
+    return detail::find_last_in<false>(str, length, set);
+}
+
+ASCII23_INLINE size_t find_last_not_in(const char* str, const size_t length, const char_set set) {
+    return detail::find_last_in<true>(str, length, set);
+}
+
+ASCII23_INLINE bool all_in(const char* str, const size_t length, const char_set set) {
+    return detail::find_first_in<true>(str, length, set) == npos;
+}
+
+namespace detail {
+
+// Convert the `A-Z` bytes of a vector to `a-z`.
+template<typename simd>
+ASCII23_FORCE_INLINE typename simd::vec simd_to_lower(
+    const typename simd::vec x
+) {
+    const typename simd::vec upper = simd::in_range(x, 'A', 'Z');
+    return simd::or_(x, simd::and_(upper, simd::set1(0x20)));
+}
+
+// Convert the `A-Z` bytes of a 64-bit word to `a-z`.
+ASCII23_FORCE_INLINE uint64_t swar_to_lower(const uint64_t word) {
+    const uint64_t heptets = word & ~SWAR_HIGH_BITS;
+    // The high bit of each byte is set when the byte is >= 'A' or > 'Z'
+    const uint64_t ge_a = heptets + SWAR_ONES * (0x80 - 'A');
+    const uint64_t gt_z = heptets + SWAR_ONES * (0x80 - 'Z' - 1);
+    const uint64_t upper = ge_a & ~gt_z & ~word & SWAR_HIGH_BITS;
+    return word | (upper >> 2);
+}
+
+// Requires `length >= simd::size`. Returns the index of the first byte
+// that differs after converting `A-Z` to `a-z`, or `length` if none.
+// When `lower_b` is true, `b` isn't converted.
+template<typename simd, bool lower_b>
+inline size_t simd_mismatch_ci(
+    const char* a, const char* b, const size_t length
+) {
+    typedef typename simd::vec vec;
+    size_t i = 0;
+    while(true) {
+        // The last vector may overlap bytes that were already compared
+        if(i + simd::size > length) {
+            i = length - simd::size;
+        }
+        const vec a_lower = simd_to_lower<simd>(simd::load(a + i));
+        const vec b_x = simd::load(b + i);
+        const vec b_lower = lower_b ? b_x : simd_to_lower<simd>(b_x);
+        const uint32_t diff = (
+            ~simd::mask(simd::eq(a_lower, b_lower)) & simd::all_bits
+        );
+        if(diff) {
+            return i + count_trailing_zeros(diff);
+        }
+        i += simd::size;
+        if(i >= length) {
+            return length;
+        }
+    }
+}
+
+template<bool lower_b>
+inline size_t mismatch_ci(const char* a, const char* b, const size_t length) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(length >= simd_avx2::size) {
+        return simd_mismatch_ci<simd_avx2, lower_b>(a, b, length);
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    if(length >= simd_sse2::size) {
+        return simd_mismatch_ci<simd_sse2, lower_b>(a, b, length);
+    }
+    #endif
+    size_t i = 0;
+    for(; i + 8 <= length; i += 8) {
+        const uint64_t a_word = load_u64(a + i);
+        const uint64_t b_word = load_u64(b + i);
+        if(swar_to_lower(a_word) != (lower_b ? b_word : swar_to_lower(b_word))) {
+            break;
+        }
+    }
+    for(; i < length; ++i) {
+        const int a_ch = to_lower_char(static_cast<unsigned char>(a[i]));
+        const int b_ch = static_cast<unsigned char>(b[i]);
+        if(a_ch != (lower_b ? b_ch : to_lower_char(b_ch))) {
+            return i;
+        }
+    }
+    return length;
+}
+
+} // namespace detail
+
+ASCII23_INLINE bool equals_ci(const char* a, const size_t a_length, const char* b, const size_t b_length) {
+    return a_length == b_length && (
+        detail::mismatch_ci<false>(a, b, a_length) == a_length
+    );
+}
+
+ASCII23_INLINE bool equals_ci_lower(const char* str, const size_t length, const char* lower, const size_t lower_length) {
+    return length == lower_length && (
+        detail::mismatch_ci<true>(str, lower, length) == length
+    );
+}
+
+ASCII23_INLINE int compare_ci(const char* a, const size_t a_length, const char* b, const size_t b_length) {
+    const size_t length = a_length < b_length ? a_length : b_length;
+    const size_t i = detail::mismatch_ci<false>(a, b, length);
+    if(i < length) {
+        return (
+            to_lower_char(static_cast<unsigned char>(a[i])) -
+            to_lower_char(static_cast<unsigned char>(b[i]))
+        );
+    }
+    return a_length < b_length ? -1 : a_length > b_length ? +1 : 0;
+}
+
+ASCII23_INLINE bool starts_with_ci(const char* str, const size_t length, const char* prefix, const size_t prefix_length) {
+    return length >= prefix_length && (
+        detail::mismatch_ci<false>(str, prefix, prefix_length) == prefix_length
+    );
+}
+
+ASCII23_INLINE bool ends_with_ci(const char* str, const size_t length, const char* suffix, const size_t suffix_length) {
+    return length >= suffix_length && detail::mismatch_ci<false>(
+        str + (length - suffix_length), suffix, suffix_length
+    ) == suffix_length;
+}
+
+namespace detail {
+
+// Constants and mixing steps for `hash_ci`, following XXH64.
+const uint64_t HASH_PRIME_1 = 0x9e3779b185ebca87ull;
+const uint64_t HASH_PRIME_2 = 0xc2b2ae3d27d4eb4full;
+const uint64_t HASH_PRIME_3 = 0x165667b19e3779f9ull;
+const uint64_t HASH_PRIME_4 = 0x85ebca77c2b2ae63ull;
+const uint64_t HASH_PRIME_5 = 0x27d4eb2f165667c5ull;
+
+ASCII23_FORCE_INLINE uint64_t rotate_left(const uint64_t x, const int bits) {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+ASCII23_FORCE_INLINE uint64_t hash_round(const uint64_t acc, const uint64_t word) {
+    return rotate_left(acc + word * HASH_PRIME_2, 31) * HASH_PRIME_1;
+}
+
+ASCII23_FORCE_INLINE uint64_t hash_merge(const uint64_t acc, const uint64_t lane) {
+    return (acc ^ hash_round(0, lane)) * HASH_PRIME_1 + HASH_PRIME_4;
+}
+
+// Read 32 bytes as four 64-bit words, with `A-Z` converted to `a-z`.
+ASCII23_FORCE_INLINE void load_lower_stripe(const char* ptr, uint64_t* words) {
+    #if defined(ASCII23_SIMD_AVX2)
+    simd_avx2::store(
+        reinterpret_cast<char*>(words),
+        simd_to_lower<simd_avx2>(simd_avx2::load(ptr))
+    );
+    #elif defined(ASCII23_SIMD_SSE2)
+    simd_sse2::store(
+        reinterpret_cast<char*>(words),
+        simd_to_lower<simd_sse2>(simd_sse2::load(ptr))
+    );
+    simd_sse2::store(
+        reinterpret_cast<char*>(words + 2),
+        simd_to_lower<simd_sse2>(simd_sse2::load(ptr + 16))
+    );
+    #else
+    for(int k = 0; k < 4; ++k) {
+        words[k] = swar_to_lower(load_u64(ptr + 8 * k));
+    }
+    #endif
+}
+
+} // namespace detail
+
+ASCII23_INLINE uint64_t hash_ci(const char* str, const size_t length, const uint64_t seed) {
+    using namespace detail;
+    size_t i = 0;
+    uint64_t hash;
+    if(length >= 32) {
+        uint64_t lanes[4] = {
+            seed + HASH_PRIME_1 + HASH_PRIME_2,
+            seed + HASH_PRIME_2,
+            seed,
+            seed - HASH_PRIME_1,
+        };
+        uint64_t words[4];
+        for(; i + 32 <= length; i += 32) {
+            load_lower_stripe(str + i, words);
+            for(int k = 0; k < 4; ++k) {
+                lanes[k] = hash_round(lanes[k], words[k]);
+            }
+        }
+        hash = (
+            rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7) +
+            rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18)
+        );
+        for(int k = 0; k < 4; ++k) {
+            hash = hash_merge(hash, lanes[k]);
+        }
+    }
+    else {
+        hash = seed + HASH_PRIME_5;
+    }
+    hash += static_cast<uint64_t>(length);
+    for(; i + 8 <= length; i += 8) {
+        hash ^= hash_round(0, swar_to_lower(load_u64(str + i)));
+        hash = rotate_left(hash, 27) * HASH_PRIME_1 + HASH_PRIME_4;
+    }
+    for(; i < length; ++i) {
+        hash ^= static_cast<uint64_t>(
+            to_lower_char(static_cast<unsigned char>(str[i]))
+        ) * HASH_PRIME_5;
+        hash = rotate_left(hash, 11) * HASH_PRIME_1;
+    }
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+ASCII23_INLINE span trim(const char* str, const size_t length, const int flags) {
+    const span left = ltrim(str, length, flags);
+    const span right = rtrim(str + left.offset, left.length, flags);
+    span result;
+    result.offset = left.offset;
+    result.length = right.length;
+    return result;
+}
+
+ASCII23_INLINE span ltrim(const char* str, const size_t length, const int flags) {
+    const size_t start = detail::find_first_flags<true>(str, length, flags);
+    span result;
+    result.offset = start == npos ? length : start;
+    result.length = length - result.offset;
+    return result;
+}
+
+ASCII23_INLINE span rtrim(const char* str, const size_t length, const int flags) {
+    const size_t last = detail::find_last_flags<true>(str, length, flags);
+    span result;
+    result.offset = 0;
+    result.length = last == npos ? 0 : last + 1;
+    return result;
+}
+
+namespace detail {
+
+// Collects tokens for `tokenize_flags` and `tokenize_in`.
+struct token_writer {
+    span* const tokens;
+    const size_t max_tokens;
+    size_t count;
+    // Offset of the current token, or `npos` when between tokens.
+    size_t token_start;
+    token_writer(span* output, const size_t capacity) :
+        tokens(output), max_tokens(capacity), count(0), token_start(npos) {}
+    // Called where a token starts or ends.
+    // Returns true once the output is full.
+    ASCII23_FORCE_INLINE bool boundary(const size_t i) {
+        if(token_start == npos) {
+            token_start = i;
+            return false;
+        }
+        tokens[count].offset = token_start;
+        tokens[count].length = i - token_start;
+        token_start = npos;
+        return ++count == max_tokens;
+    }
+};
+
+// Token boundaries are where a vector's non-delimiter bits differ
+// from the same bits shifted by one, carrying the last bit between
+// vectors. Returns true once the output is full.
+template<typename simd, typename classifier>
+inline bool simd_tokenize(
+    const char* str, const size_t length, size_t& i,
+    const classifier& classify, token_writer& writer
+) {
+    uint32_t carry = writer.token_start == npos ? 0 : 1;
+    for(; i + simd::size <= length; i += simd::size) {
+        const uint32_t bits = simd_bits<simd, true>(str + i, classify);
+        uint32_t boundaries = (bits ^ ((bits << 1) | carry)) & simd::all_bits;
+        carry = bits >> (simd::size - 1);
+        while(boundaries) {
+            if(writer.boundary(i + count_trailing_zeros(boundaries))) {
+                return true;
+            }
+            boundaries &= boundaries - 1;
+        }
+    }
+    return false;
+}
+
+template<typename classifier>
+inline size_t scalar_tokenize(
+    const char* str, const size_t length, size_t i,
+    const classifier& classify, token_writer& writer
+) {
+    for(; i < length; ++i) {
+        const bool delimiter = classify(str[i]);
+        if(delimiter == (writer.token_start != npos) && writer.boundary(i)) {
+            return writer.count;
+        }
+    }
+    if(writer.token_start != npos) {
+        writer.boundary(length);
+    }
+    return writer.count;
+}
+
+ASCII23_FORCE_INLINE size_t tokenize_flags(
+    const char* str, const size_t length, size_t i, const int flags,
+    token_writer& writer
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(simd_tokenize<simd_avx2>(
+        str, length, i, simd_flags_classifier<simd_avx2>(flags), writer
+    )) {
+        return writer.count;
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    if(simd_tokenize<simd_sse2>(
+        str, length, i, simd_flags_classifier<simd_sse2>(flags), writer
+    )) {
+        return writer.count;
+    }
+    #endif
+    return scalar_tokenize(str, length, i, flags_classifier(flags), writer);
+}
+
+ASCII23_FORCE_INLINE size_t tokenize_in(
+    const char* str, const size_t length, size_t i, const char_set set,
+    token_writer& writer
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(simd_tokenize<simd_avx2>(
+        str, length, i, simd_char_set_classifier<simd_avx2>(set), writer
+    )) {
+        return writer.count;
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSSE3)
+    if(simd_tokenize<simd_sse2>(
+        str, length, i, simd_char_set_classifier<simd_sse2>(set), writer
+    )) {
+        return writer.count;
+    }
+    #endif
+    return scalar_tokenize(str, length, i, char_set_classifier(set), writer);
+}
+
+} // namespace detail
+
+ASCII23_INLINE size_t tokenize_flags(const char* str, const size_t length, const size_t offset, const int flags, span* tokens, const size_t max_tokens) {
+    if(offset >= length || max_tokens == 0) {
+        return 0;
+    }
+    detail::token_writer writer(tokens, max_tokens);
+    return detail::tokenize_flags(str, length, offset, flags, writer);
+}
+
+ASCII23_INLINE size_t tokenize_in(const char* str, const size_t length, const size_t offset, const char_set set, span* tokens, const size_t max_tokens) {
+    if(offset >= length || max_tokens == 0) {
+        return 0;
+    }
+    detail::token_writer writer(tokens, max_tokens);
+    return detail::tokenize_in(str, length, offset, set, writer);
+}
+
+namespace detail {
+
+// Bits for the bytes of a vector with `CHAR_FLAG_WORD`,
+// `CHAR_FLAG_WORD_START`, `CHAR_FLAG_LOWER`, and `CHAR_FLAG_UPPER`.
+struct identifier_bits {
+    uint32_t word;
+    uint32_t start;
+    uint32_t lower;
+    uint32_t upper;
+};
+
+template<typename simd>
+ASCII23_FORCE_INLINE identifier_bits simd_identifier_bits(const char* ptr) {
+    typedef typename simd::vec vec;
+    const vec x = simd::load(ptr);
+    const vec lower = simd::in_range(x, 'a', 'z');
+    const vec upper = simd::in_range(x, 'A', 'Z');
+    const vec start = simd::or_(
+        simd::or_(lower, upper), simd::eq(x, simd::set1('_'))
+    );
+    identifier_bits bits;
+    bits.word = simd::mask(simd::or_(start, simd::in_range(x, '0', '9')));
+    bits.start = simd::mask(start);
+    bits.lower = simd::mask(lower);
+    bits.upper = simd::mask(upper);
+    return bits;
+}
+
+// Letter case of the bytes selected by `include`.
+ASCII23_FORCE_INLINE int identifier_case(
+    const identifier_bits& bits, const uint32_t include
+) {
+    return (
+        ((bits.lower & include) ? IDENTIFIER_CASE_LOWER : 0) |
+        ((bits.upper & include) ? IDENTIFIER_CASE_UPPER : 0)
+    );
+}
+
+// Advances `i` past word bytes, accumulating their letter case.
+// Returns true if a byte that isn't a word byte was found.
+template<typename simd>
+inline bool simd_scan_word(
+    const char* str, const size_t length, size_t& i, int& letter_case
+) {
+    for(; i + simd::size <= length; i += simd::size) {
+        const identifier_bits bits = simd_identifier_bits<simd>(str + i);
+        const uint32_t end = ~bits.word & simd::all_bits;
+        if(end) {
+            letter_case |= identifier_case(bits, (end - 1) & ~end);
+            i += count_trailing_zeros(end);
+            return true;
+        }
+        letter_case |= identifier_case(bits, simd::all_bits);
+    }
+    return false;
+}
+
+inline size_t scalar_scan_word(
+    const char* str, const size_t length, size_t i, int& letter_case
+) {
+    for(; i < length; ++i) {
+        const int ch = static_cast<unsigned char>(str[i]);
+        if(!is_word_char(ch)) {
+            break;
+        }
+        letter_case |= (
+            (is_alpha_lower_char(ch) ? IDENTIFIER_CASE_LOWER : 0) |
+            (is_alpha_upper_char(ch) ? IDENTIFIER_CASE_UPPER : 0)
+        );
+    }
+    return i;
+}
+
+// Returns the end of the run of word bytes beginning at `i`.
+ASCII23_FORCE_INLINE size_t scan_word(
+    const char* str, const size_t length, size_t i, int& letter_case
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(simd_scan_word<simd_avx2>(str, length, i, letter_case)) {
+        return i;
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    if(simd_scan_word<simd_sse2>(str, length, i, letter_case)) {
+        return i;
+    }
+    #endif
+    return scalar_scan_word(str, length, i, letter_case);
+}
+
+// Identifiers begin at word start bytes not preceded by word bytes.
+// `carry` is set when the byte before `i` is a word byte.
+// Returns true if an identifier was found, setting `id`. The end of the
+// identifier is found using the same vector as its start, if possible.
+template<typename simd>
+inline bool simd_find_identifier(
+    const char* str, const size_t length, size_t& i, uint32_t& carry,
+    identifier_span& id
+) {
+    for(; i + simd::size <= length; i += simd::size) {
+        const identifier_bits bits = simd_identifier_bits<simd>(str + i);
+        const uint32_t starts = bits.start & ~((bits.word << 1) | carry);
+        if(starts) {
+            const uint32_t start = count_trailing_zeros(starts);
+            const uint32_t rest = (simd::all_bits << start) & simd::all_bits;
+            const uint32_t ends = ~bits.word & rest;
+            id.offset = i + start;
+            if(ends) {
+                id.letter_case = identifier_case(bits, rest & (ends - 1) & ~ends);
+                id.length = i + count_trailing_zeros(ends) - id.offset;
+            }
+            else {
+                id.letter_case = identifier_case(bits, rest);
+                id.length = scan_word(
+                    str, length, i + simd::size, id.letter_case
+                ) - id.offset;
+            }
+            return true;
+        }
+        carry = bits.word >> (simd::size - 1);
+    }
+    return false;
+}
+
+inline bool scalar_find_identifier(
+    const char* str, const size_t length, size_t i, uint32_t carry,
+    identifier_span& id
+) {
+    for(; i < length; ++i) {
+        const int ch = static_cast<unsigned char>(str[i]);
+        if(!carry && is_word_start_char(ch)) {
+            id.offset = i;
+            id.length = scan_word(str, length, i, id.letter_case) - i;
+            return true;
+        }
+        carry = is_word_char(ch);
+    }
+    return false;
+}
+
+ASCII23_FORCE_INLINE bool find_identifier(
+    const char* str, const size_t length, size_t i, identifier_span& id
+) {
+    uint32_t carry = i > 0 && is_word_char(static_cast<unsigned char>(str[i - 1]));
+    #if defined(ASCII23_SIMD_AVX2)
+    if(simd_find_identifier<simd_avx2>(str, length, i, carry, id)) {
+        return true;
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    if(simd_find_identifier<simd_sse2>(str, length, i, carry, id)) {
+        return true;
+    }
+    #endif
+    return scalar_find_identifier(str, length, i, carry, id);
+}
+
+} // namespace detail
+
+ASCII23_INLINE identifier_span scan_identifier(const char* str, const size_t length) {
+    identifier_span result;
+    result.offset = 0;
+    result.length = 0;
+    result.letter_case = IDENTIFIER_CASE_NONE;
+    if(length && is_word_start_char(static_cast<unsigned char>(str[0]))) {
+        result.length = detail::scan_word(str, length, 0, result.letter_case);
+    }
+    return result;
+}
+
+ASCII23_INLINE identifier_span next_identifier(const char* str, const size_t length, const size_t offset) {
+    identifier_span result;
+    result.length = 0;
+    result.letter_case = IDENTIFIER_CASE_NONE;
+    if(offset >= length || !detail::find_identifier(str, length, offset, result)) {
+        result.offset = npos;
+    }
+    return result;
+}
+
+namespace detail {
+
+// Digits for `hex_encode`, in lower and upper case.
+const char HEX_DIGITS_LOWER[] = "0123456789abcdef";
+const char HEX_DIGITS_UPPER[] = "0123456789ABCDEF";
+
+// Map nibbles to hexadecimal digits.
+template<typename simd>
+ASCII23_FORCE_INLINE typename simd::vec simd_hex_digits(
+    const typename simd::vec nibbles, const char letter
+) {
+    const typename simd::vec letters = simd::and_(
+        simd::in_range(nibbles, 10, 15), simd::set1(letter - '0' - 10)
+    );
+    return simd::add(simd::add(nibbles, simd::set1('0')), letters);
+}
+
+// Returns the number of bytes of `src` that were encoded.
+template<typename simd>
+inline size_t simd_hex_encode(
+    const char* src, const size_t length, char* dst, const char letter
+) {
+    typedef typename simd::vec vec;
+    size_t i = 0;
+    for(; i + simd::size <= length; i += simd::size) {
+        const vec x = simd::load(src + i);
+        simd::store_interleaved(dst + 2 * i,
+            simd_hex_digits<simd>(simd::high_nibbles(x), letter),
+            simd_hex_digits<simd>(simd::and_(x, simd::set1(0x0f)), letter)
+        );
+    }
+    return i;
+}
+
+// Map hexadecimal digits to nibbles. Sets `invalid` to a mask of the
+// bytes that aren't digits accepted by `letter_case`.
+template<typename simd>
+ASCII23_FORCE_INLINE typename simd::vec simd_hex_nibbles(
+    const typename simd::vec x, const int letter_case, uint32_t& invalid
+) {
+    typedef typename simd::vec vec;
+    const vec digit = simd::in_range(x, '0', '9');
+    // Setting the 0x20 bit maps A-F onto a-f
+    const vec folded = simd::or_(x, simd::set1(0x20));
+    const vec alpha = (
+        letter_case == HEX_CASE_LOWER ? simd::in_range(x, 'a', 'f') :
+        letter_case == HEX_CASE_UPPER ? simd::in_range(x, 'A', 'F') :
+        simd::in_range(folded, 'a', 'f')
+    );
+    invalid = ~simd::mask(simd::or_(digit, alpha)) & simd::all_bits;
+    return simd::or_(
+        simd::and_(digit, simd::sub(x, simd::set1('0'))),
+        simd::and_(alpha, simd::sub(folded, simd::set1('a' - 10)))
+    );
+}
+
+// Returns the number of bytes of `src` that were decoded, stopping
+// before any vector containing an invalid byte.
+template<typename simd>
+inline size_t simd_hex_decode(
+    const char* src, const size_t length, char* dst, const int letter_case
+) {
+    size_t i = 0;
+    for(; i + simd::size <= length; i += simd::size) {
+        uint32_t invalid;
+        const typename simd::vec nibbles = simd_hex_nibbles<simd>(
+            simd::load(src + i), letter_case, invalid
+        );
+        if(invalid) {
+            break;
+        }
+        simd::store_nibble_pairs(dst + i / 2, nibbles);
+    }
+    return i;
+}
+
+// Value of a hexadecimal digit accepted by `letter_case`, or -1.
+ASCII23_FORCE_INLINE int hex_nibble(const char ch, const int letter_case) {
+    const int uch = static_cast<unsigned char>(ch);
+    if(uch >= '0' && uch <= '9') {
+        return uch - '0';
+    }
+    else if(letter_case != HEX_CASE_UPPER && uch >= 'a' && uch <= 'f') {
+        return uch - 'a' + 10;
+    }
+    else if(letter_case != HEX_CASE_LOWER && uch >= 'A' && uch <= 'F') {
+        return uch - 'A' + 10;
+    }
+    return -1;
+}
+
+} // namespace detail
+
+ASCII23_INLINE void hex_encode(const char* src, const size_t length, char* dst, const bool upper) {
+    const char* digits = upper ? detail::HEX_DIGITS_UPPER : detail::HEX_DIGITS_LOWER;
+    size_t i = 0;
+    #if defined(ASCII23_SIMD_AVX2)
+    i += detail::simd_hex_encode<detail::simd_avx2>(
+        src + i, length - i, dst + 2 * i, digits[10]
+    );
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    i += detail::simd_hex_encode<detail::simd_sse2>(
+        src + i, length - i, dst + 2 * i, digits[10]
+    );
+    #endif
+    for(; i < length; ++i) {
+        const unsigned char uch = static_cast<unsigned char>(src[i]);
+        dst[2 * i] = digits[uch >> 4];
+        dst[2 * i + 1] = digits[uch & 0x0f];
+    }
+}
+
+ASCII23_INLINE size_t hex_decode(const char* src, const size_t length, char* dst, const int letter_case) {
+    size_t i = 0;
+    #if defined(ASCII23_SIMD_AVX2)
+    i += detail::simd_hex_decode<detail::simd_avx2>(
+        src + i, length - i, dst + i / 2, letter_case
+    );
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    i += detail::simd_hex_decode<detail::simd_sse2>(
+        src + i, length - i, dst + i / 2, letter_case
+    );
+    #endif
+    for(; i + 1 < length; i += 2) {
+        const int high = detail::hex_nibble(src[i], letter_case);
+        if(high < 0) {
+            return i;
+        }
+        const int low = detail::hex_nibble(src[i + 1], letter_case);
+        if(low < 0) {
+            return i + 1;
+        }
+        dst[i / 2] = static_cast<char>((high << 4) | low);
+    }
+    return i < length ? i : npos;
+}
+
+namespace detail {
+
+// True if all 8 bytes of a word, as read by `load_u64_le`, are `0-9`.
+// Adding 6 carries into the high nibble for bytes above `9`.
+ASCII23_FORCE_INLINE bool swar_all_digits(const uint64_t word) {
+    const uint64_t high_nibbles = 0xf0f0f0f0f0f0f0f0ull;
+    return (
+        ((word & high_nibbles) | (((word + 6 * SWAR_ONES) & high_nibbles) >> 4)) ==
+        0x3333333333333333ull
+    );
+}
+
+// Value of 8 decimal digits, as read by `load_u64_le`.
+// Pairs of digits, then of 2-digit numbers, then of 4-digit numbers,
+// are combined using one multiply each.
+ASCII23_FORCE_INLINE uint64_t swar_digits_value(uint64_t word) {
+    word = ((word & 0x0f0f0f0f0f0f0f0full) * (10 * 0x100 + 1)) >> 8;
+    word = ((word & 0x00ff00ff00ff00ffull) * (100 * 0x10000 + 1)) >> 16;
+    return ((word & 0x0000ffff0000ffffull) * (10000 * 0x100000000ull + 1)) >> 32;
+}
+
+// Parses digits in the given base, for `parse_uint` and `parse_int`.
+// Saturates to `limit` and sets `overflow` if the value is too large.
+// `limit` must be at least `INT64_MAX`. Returns the number of digits.
+inline size_t parse_digits(
+    const char* str, const size_t length, const int base,
+    const uint64_t limit, uint64_t& value, bool& overflow
+) {
+    size_t i = 0;
+    uint64_t result = 0;
+    if(base == 10) {
+        // Any 18 decimal digits fit without checking for overflow
+        const size_t unchecked = length < 18 ? length : 18;
+        for(; i + 8 <= unchecked; i += 8) {
+            const uint64_t word = load_u64_le(str + i);
+            if(!swar_all_digits(word)) {
+                break;
+            }
+            result = result * 100000000 + swar_digits_value(word);
+        }
+        for(; i < unchecked; ++i) {
+            const int digit = digit_value(static_cast<unsigned char>(str[i]));
+            if(digit < 0) {
+                value = result;
+                return i;
+            }
+            result = result * 10 + static_cast<uint64_t>(digit);
+        }
+    }
+    const uint64_t ubase = static_cast<uint64_t>(base);
+    const uint64_t max_before_digit = limit / ubase;
+    for(; i < length; ++i) {
+        const int digit = radix_digit_value(static_cast<unsigned char>(str[i]), base);
+        if(digit < 0) {
+            break;
+        }
+        const uint64_t udigit = static_cast<uint64_t>(digit);
+        if(result > max_before_digit || (
+            result == max_before_digit && udigit > limit % ubase
+        )) {
+            overflow = true;
+            result = limit;
+            while(i < length && radix_digit_value(
+                static_cast<unsigned char>(str[i]), base
+            ) >= 0) {
+                ++i;
+            }
+            break;
+        }
+        result = result * ubase + udigit;
+    }
+    value = result;
+    return i;
+}
+
+} // namespace detail
+
+ASCII23_INLINE parse_uint_result parse_uint(const char* str, const size_t length, const int base) {
+    parse_uint_result result;
+    result.value = 0;
+    result.length = 0;
+    result.overflow = false;
+    if(base >= 2 && base <= 36) {
+        result.length = detail::parse_digits(
+            str, length, base, ~static_cast<uint64_t>(0),
+            result.value, result.overflow
+        );
+    }
+    return result;
+}
+
+ASCII23_INLINE parse_int_result parse_int(const char* str, const size_t length, const int base) {
+    parse_int_result result;
+    result.value = 0;
+    result.length = 0;
+    result.overflow = false;
+    if(base < 2 || base > 36) {
+        return result;
+    }
+    const bool negative = length && str[0] == '-';
+    const size_t sign = (negative || (length && str[0] == '+')) ? 1 : 0;
+    // The magnitude of the smallest value is one more than the largest
+    const uint64_t limit = (
+        static_cast<uint64_t>(INT64_MAX) + (negative ? 1 : 0)
+    );
+    uint64_t magnitude = 0;
+    const size_t digits = detail::parse_digits(
+        str + sign, length - sign, base, limit, magnitude, result.overflow
+    );
+    if(digits) {
+        result.length = sign + digits;
+        result.value = negative ? static_cast<int64_t>(0 - magnitude) : (
+            static_cast<int64_t>(magnitude)
+        );
+    }
+    return result;
+}
+
+namespace detail {
+
+// Collects fields for `parse_int_fields`. Unlike `token_writer`, each
+// delimiter byte ends one field, so fields can be empty.
+struct field_writer {
+    span* const fields;
+    const size_t max_fields;
+    size_t count;
+    size_t field_start;
+    field_writer(span* output, const size_t capacity, const size_t start) :
+        fields(output), max_fields(capacity), count(0), field_start(start) {}
+    // Called where a field ends. Returns true once the output is full.
+    ASCII23_FORCE_INLINE bool field_end(const size_t i) {
+        fields[count].offset = field_start;
+        fields[count].length = i - field_start;
+        field_start = i + 1;
+        return ++count == max_fields;
+    }
+};
+
+// Every delimiter bit of a vector ends a field.
+// Returns true once the output is full.
+template<typename simd, typename classifier>
+inline bool simd_split_fields(
+    const char* str, const size_t length, size_t& i,
+    const classifier& classify, field_writer& writer
+) {
+    for(; i + simd::size <= length; i += simd::size) {
+        uint32_t delimiters = simd_bits<simd, false>(str + i, classify);
+        while(delimiters) {
+            if(writer.field_end(i + count_trailing_zeros(delimiters))) {
+                return true;
+            }
+            delimiters &= delimiters - 1;
+        }
+    }
+    return false;
+}
+
+// The end of the buffer ends the last field, unless a delimiter at
+// the end already did.
+template<typename classifier>
+inline size_t scalar_split_fields(
+    const char* str, const size_t length, size_t i,
+    const classifier& classify, field_writer& writer
+) {
+    for(; i < length; ++i) {
+        if(classify(str[i]) && writer.field_end(i)) {
+            return writer.count;
+        }
+    }
+    if(writer.field_start < length) {
+        writer.field_end(length);
+    }
+    return writer.count;
+}
+
+ASCII23_FORCE_INLINE size_t split_fields(
+    const char* str, const size_t length, size_t i, const int flags,
+    field_writer& writer
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(simd_split_fields<simd_avx2>(
+        str, length, i, simd_flags_classifier<simd_avx2>(flags), writer
+    )) {
+        return writer.count;
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    if(simd_split_fields<simd_sse2>(
+        str, length, i, simd_flags_classifier<simd_sse2>(flags), writer
+    )) {
+        return writer.count;
+    }
+    #endif
+    return scalar_split_fields(str, length, i, flags_classifier(flags), writer);
+}
+
+ASCII23_FORCE_INLINE size_t split_fields(
+    const char* str, const size_t length, size_t i, const char_set set,
+    field_writer& writer
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(simd_split_fields<simd_avx2>(
+        str, length, i, simd_char_set_classifier<simd_avx2>(set), writer
+    )) {
+        return writer.count;
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSSE3)
+    if(simd_split_fields<simd_sse2>(
+        str, length, i, simd_char_set_classifier<simd_sse2>(set), writer
+    )) {
+        return writer.count;
+    }
+    #endif
+    return scalar_split_fields(str, length, i, char_set_classifier(set), writer);
+}
+
+// Parses 1-8 decimal digits with one SWAR conversion.
+// At least 8 bytes must be readable at `str`. The digits are shifted
+// to the end of a word, and the bytes before them filled with `0`.
+ASCII23_FORCE_INLINE bool parse_short_decimal(
+    const char* str, const size_t digits, uint64_t& value
+) {
+    const int shift = static_cast<int>(8 * (8 - digits));
+    const uint64_t zeros = 0x3030303030303030ull & ~(~0ull << shift);
+    const uint64_t word = (load_u64_le(str) << shift) | zeros;
+    value = swar_digits_value(word);
+    return swar_all_digits(word);
+}
+
+// Parses 1-16 decimal digits with one or two SWAR conversions.
+// At least 8 bytes must be readable at `str`.
+ASCII23_FORCE_INLINE bool parse_field_decimal(
+    const char* str, const size_t digits, uint64_t& value
+) {
+    if(digits <= 8) {
+        return parse_short_decimal(str, digits, value);
+    }
+    const uint64_t low_word = load_u64_le(str + digits - 8);
+    uint64_t high;
+    const bool valid = parse_short_decimal(str, digits - 8, high);
+    value = high * 100000000 + swar_digits_value(low_word);
+    return valid && swar_all_digits(low_word);
+}
+
+// Parses one field for `parse_int_fields`.
+// Returns false if the field is empty, isn't entirely an integer,
+// or overflows.
+ASCII23_FORCE_INLINE bool parse_int_field(
+    const char* str, const size_t length, const span field, int64_t& value
+) {
+    if(field.length == 0) {
+        return false;
+    }
+    const char* ptr = str + field.offset;
+    const bool negative = ptr[0] == '-';
+    const size_t sign = (negative || ptr[0] == '+') ? 1 : 0;
+    const size_t digits = field.length - sign;
+    uint64_t magnitude;
+    if(digits >= 1 && digits <= 16 && field.offset + sign + 8 <= length) {
+        if(!parse_field_decimal(ptr + sign, digits, magnitude)) {
+            return false;
+        }
+        value = static_cast<int64_t>(magnitude);
+        value = negative ? -value : value;
+        return true;
+    }
+    const parse_int_result result = parse_int(ptr, field.length);
+    value = result.value;
+    return result.length == field.length && !result.overflow;
+}
+
+// Fields are found a batch at a time from the vectorized delimiter
+// masks, then each one is parsed.
+template<typename delimiters>
+inline parse_fields_result parse_int_fields(
+    const char* str, const size_t length, const size_t offset,
+    const delimiters& delimiter, int64_t* values, const size_t max_values
+) {
+    const size_t batch_size = 64;
+    span fields[batch_size];
+    parse_fields_result result;
+    result.count = 0;
+    result.offset = offset;
+    result.invalid = false;
+    while(result.count < max_values && result.offset < length) {
+        const size_t remaining = max_values - result.count;
+        const size_t batch = remaining < batch_size ? remaining : batch_size;
+        field_writer writer(fields, batch, result.offset);
+        const size_t found = split_fields(
+            str, length, result.offset, delimiter, writer
+        );
+        for(size_t i = 0; i < found; ++i) {
+            if(!parse_int_field(str, length, fields[i], values[result.count])) {
+                result.offset = fields[i].offset;
+                result.invalid = true;
+                return result;
+            }
+            ++result.count;
+            // Continue after the field's delimiter
+            const size_t end = fields[i].offset + fields[i].length;
+            result.offset = end < length ? end + 1 : length;
+        }
+        if(found < batch) {
+            break;
+        }
+    }
+    return result;
+}
+
+} // namespace detail
+
+ASCII23_INLINE parse_fields_result parse_int_fields_flags(const char* str, const size_t length, const size_t offset, const int flags, int64_t* values, const size_t max_values) {
+    return detail::parse_int_fields(str, length, offset, flags, values, max_values);
+}
+
+ASCII23_INLINE parse_fields_result parse_int_fields_in(const char* str, const size_t length, const size_t offset, const char_set set, int64_t* values, const size_t max_values) {
+    return detail::parse_int_fields(str, length, offset, set, values, max_values);
+}
+
+namespace detail {
+
+// Every two-digit decimal number, so that digits can be written in
+// pairs with one lookup.
+const char DECIMAL_DIGIT_PAIRS[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Powers of 10 up to 10^19, for `format_uint_length`.
+const uint64_t POWERS_OF_10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+    10000000ull, 100000000ull, 1000000000ull, 10000000000ull,
+    100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+    100000000000000000ull, 1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+// Writes the digits of `value` ending just before `end`.
+ASCII23_FORCE_INLINE void format_decimal_backward(uint64_t value, char* end) {
+    while(value >= 100) {
+        const size_t pair = static_cast<size_t>(value % 100) * 2;
+        value /= 100;
+        end -= 2;
+        end[0] = DECIMAL_DIGIT_PAIRS[pair];
+        end[1] = DECIMAL_DIGIT_PAIRS[pair + 1];
+    }
+    if(value >= 10) {
+        end[-2] = DECIMAL_DIGIT_PAIRS[value * 2];
+        end[-1] = DECIMAL_DIGIT_PAIRS[value * 2 + 1];
+    }
+    else {
+        end[-1] = static_cast<char>('0' + value);
+    }
+}
+
+} // namespace detail
+
+ASCII23_INLINE size_t format_uint_length(const uint64_t value) {
+    if(value == 0) {
+        return 1;
+    }
+    // 1233 / 4096 approximates log10(2), giving the number of digits
+    // or one more than it
+    const size_t guess = static_cast<size_t>(
+        ((detail::highest_bit_index(value) + 1) * 1233) >> 12
+    );
+    return guess + (value >= detail::POWERS_OF_10[guess] ? 1 : 0);
+}
+
+ASCII23_INLINE size_t format_int_length(const int64_t value) {
+    return value < 0 ? 1 + format_uint_length(
+        0 - static_cast<uint64_t>(value)
+    ) : format_uint_length(static_cast<uint64_t>(value));
+}
+
+ASCII23_INLINE size_t format_hex_length(const uint64_t value) {
+    return value ? static_cast<size_t>(detail::highest_bit_index(value) / 4 + 1) : 1;
+}
+
+ASCII23_INLINE size_t format_uint(const uint64_t value, char* dst) {
+    const size_t length = format_uint_length(value);
+    detail::format_decimal_backward(value, dst + length);
+    return length;
+}
+
+ASCII23_INLINE size_t format_int(const int64_t value, char* dst) {
+    if(value < 0) {
+        dst[0] = '-';
+        return 1 + format_uint(0 - static_cast<uint64_t>(value), dst + 1);
+    }
+    return format_uint(static_cast<uint64_t>(value), dst);
+}
+
+ASCII23_INLINE size_t format_hex(const uint64_t value, char* dst, const bool upper) {
+    const char* digits = upper ? detail::HEX_DIGITS_UPPER : detail::HEX_DIGITS_LOWER;
+    const size_t length = format_hex_length(value);
+    uint64_t remaining = value;
+    for(size_t i = length; i > 0; --i) {
+        dst[i - 1] = digits[remaining & 0x0f];
+        remaining >>= 4;
+    }
+    return length;
+}
+
+namespace detail {
+
+// Length of the run of `0-9` bytes at the start of a buffer.
+ASCII23_FORCE_INLINE size_t digit_run_length(const char* str, const size_t length) {
+    const size_t end = find_first_flags<true>(str, length, CHAR_FLAG_DIGIT);
+    return end == npos ? length : end;
+}
+
+// Value of a run of decimal digits, which must not overflow.
+ASCII23_FORCE_INLINE uint64_t digits_value(const char* str, const size_t count) {
+    uint64_t value = 0;
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8) {
+        value = value * 100000000 + swar_digits_value(load_u64_le(str + i));
+    }
+    for(; i < count; ++i) {
+        value = value * 10 + static_cast<uint64_t>(str[i] - '0');
+    }
+    return value;
+}
+
+// Powers of 10 that are exactly representable as a double.
+const double EXACT_POWERS_OF_10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Clinger's fast path: When the mantissa and the power of 10 are both
+// exactly representable, one multiplication or division is correctly
+// rounded. Requires the compiler to not use extended precision.
+ASCII23_FORCE_INLINE bool parse_double_fast(
+    uint64_t mantissa, int64_t exponent, double& value
+) {
+    #if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    const uint64_t max_exact = static_cast<uint64_t>(1) << 53;
+    if(mantissa > max_exact || exponent < -22 || exponent > 22 + 15) {
+        return false;
+    }
+    // Move excess powers of 10 into the mantissa, if that's exact
+    for(; exponent > 22; --exponent) {
+        mantissa *= 10;
+        if(mantissa > max_exact) {
+            return false;
+        }
+    }
+    const double m = static_cast<double>(mantissa);
+    value = exponent < 0 ? m / EXACT_POWERS_OF_10[-exponent] : (
+        m * EXACT_POWERS_OF_10[exponent]
+    );
+    return true;
+    #else
+    (void) mantissa;
+    (void) exponent;
+    (void) value;
+    return false;
+    #endif
+}
+
+// The number of significant digits that can affect the rounding of a
+// double. Digits past these are replaced with one nonzero digit.
+const size_t PARSE_DOUBLE_MAX_DIGITS = 768;
+
+// Exact fallback: The significant digits are copied without a decimal
+// point, so that `strtod` can't be affected by the locale's decimal
+// point character.
+inline double parse_double_slow(
+    const char* int_digits, const size_t int_count,
+    const char* frac_digits, const size_t frac_count, int64_t exponent
+) {
+    char buffer[PARSE_DOUBLE_MAX_DIGITS + 24];
+    size_t count = 0;
+    bool truncated = false;
+    for(size_t part = 0; part < 2; ++part) {
+        const char* digits = part ? frac_digits : int_digits;
+        const size_t digits_count = part ? frac_count : int_count;
+        for(size_t i = 0; i < digits_count; ++i) {
+            if(count < PARSE_DOUBLE_MAX_DIGITS) {
+                buffer[count++] = digits[i];
+            }
+            else {
+                truncated = truncated || digits[i] != '0';
+                ++exponent;
+            }
+        }
+    }
+    if(truncated) {
+        buffer[count++] = '1';
+        --exponent;
+    }
+    buffer[count++] = 'e';
+    count += format_int(exponent, buffer + count);
+    buffer[count] = 0;
+    return std::strtod(buffer, nullptr);
+}
+
+// Parses `inf`, `infinity`, or `nan`. Returns the length, or 0.
+inline size_t parse_double_special(
+    const char* str, const size_t length, double& value
+) {
+    if(starts_with_ci(str, length, "infinity", 8)) {
+        value = std::numeric_limits<double>::infinity();
+        return 8;
+    }
+    else if(starts_with_ci(str, length, "inf", 3)) {
+        value = std::numeric_limits<double>::infinity();
+        return 3;
+    }
+    else if(starts_with_ci(str, length, "nan", 3)) {
+        value = std::numeric_limits<double>::quiet_NaN();
+        return 3;
+    }
+    return 0;
+}
+
+} // namespace detail
+
+ASCII23_INLINE parse_double_result parse_double(const char* str, const size_t length) {
+    parse_double_result result;
+    result.value = 0;
+    result.length = 0;
+    const bool negative = length && str[0] == '-';
+    size_t i = (negative || (length && str[0] == '+')) ? 1 : 0;
+    // Integer and fraction digits
+    const char* int_digits = str + i;
+    size_t int_count = detail::digit_run_length(str + i, length - i);
+    i += int_count;
+    const char* frac_digits = str + i;
+    size_t frac_count = 0;
+    if(i < length && str[i] == '.') {
+        frac_digits = str + i + 1;
+        frac_count = detail::digit_run_length(str + i + 1, length - i - 1);
+        if(int_count || frac_count) {
+            i += 1 + frac_count;
+        }
+    }
+    if(!int_count && !frac_count) {
+        const size_t special = detail::parse_double_special(
+            str + i, length - i, result.value
+        );
+        if(special) {
+            result.value = negative ? -result.value : result.value;
+            result.length = i + special;
+        }
+        return result;
+    }
+    // Exponent, which is clamped well beyond the range of a double
+    int64_t exponent = 0;
+    if(i < length && (str[i] == 'e' || str[i] == 'E')) {
+        size_t j = i + 1;
+        const bool exponent_negative = j < length && str[j] == '-';
+        j += (exponent_negative || (j < length && str[j] == '+')) ? 1 : 0;
+        const size_t exponent_count = detail::digit_run_length(str + j, length - j);
+        if(exponent_count) {
+            for(size_t k = 0; k < exponent_count && exponent < 100000000; ++k) {
+                exponent = exponent * 10 + (str[j + k] - '0');
+            }
+            exponent = exponent_negative ? -exponent : exponent;
+            i = j + exponent_count;
+        }
+    }
+    result.length = i;
+    // Leading zeros aren't significant. The value is the significant
+    // digits, as an integer, times 10 to the power of `exponent`.
+    while(int_count && int_digits[0] == '0') {
+        ++int_digits;
+        --int_count;
+    }
+    if(!int_count) {
+        while(frac_count && frac_digits[0] == '0') {
+            ++frac_digits;
+            --frac_count;
+            --exponent;
+        }
+    }
+    exponent -= static_cast<int64_t>(frac_count);
+    if(!int_count && !frac_count) {
+        result.value = negative ? -0.0 : 0.0;
+        return result;
+    }
+    if(int_count + frac_count <= 19) {
+        const uint64_t mantissa = (
+            detail::digits_value(int_digits, int_count) *
+            detail::POWERS_OF_10[frac_count] +
+            detail::digits_value(frac_digits, frac_count)
+        );
+        if(detail::parse_double_fast(mantissa, exponent, result.value)) {
+            result.value = negative ? -result.value : result.value;
+            return result;
+        }
+    }
+    result.value = detail::parse_double_slow(
+        int_digits, int_count, frac_digits, frac_count, exponent
+    );
+    result.value = negative ? -result.value : result.value;
+    return result;
+}
+
+namespace detail {
+
+// Layout of the date and time in a timestamp. `d` is any digit.
+const char ISO8601_LAYOUT[] = "dddd-dd-ddTdd:dd:dd";
+const size_t ISO8601_LAYOUT_LENGTH = 19;
+
+ASCII23_FORCE_INLINE bool is_iso8601_time_separator(const char ch) {
+    return ch == 'T' || ch == 't' || ch == ' ';
+}
+
+// Returns the offset of the first byte not matching the layout,
+// or `npos`. Stops at `length`, returning it if that's too short.
+inline size_t scalar_iso8601_layout_error(
+    const char* str, const size_t length, size_t i
+) {
+    for(; i < ISO8601_LAYOUT_LENGTH; ++i) {
+        if(i >= length) {
+            return i;
+        }
+        const char expected = ISO8601_LAYOUT[i];
+        const bool valid = (
+            expected == 'd' ? is_digit_char(static_cast<unsigned char>(str[i])) :
+            expected == 'T' ? is_iso8601_time_separator(str[i]) :
+            str[i] == expected
+        );
+        if(!valid) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+#if defined(ASCII23_SIMD_SSE2)
+// Checks the first 16 bytes of the layout with one digit class mask and
+// one compare against the expected separators, then the rest as scalar.
+inline size_t simd_iso8601_layout_error(const char* str, const size_t length) {
+    typedef simd_sse2::vec vec;
+    const uint32_t digit_bits = 0xdb6f;
+    const uint32_t separator_bits = 0x2090;
+    const uint32_t time_separator_bit = 0x0400;
+    const vec x = simd_sse2::load(str);
+    const uint32_t digits = simd_sse2::mask(simd_sse2::in_range(x, '0', '9'));
+    const uint32_t separators = simd_sse2::mask(
+        simd_sse2::eq(x, simd_sse2::load("0000-00-00T00:00"))
+    );
+    const uint32_t valid = (
+        (digits & digit_bits) | (separators & separator_bits) |
+        (is_iso8601_time_separator(str[10]) ? time_separator_bit : 0)
+    );
+    const uint32_t invalid = ~valid & simd_sse2::all_bits;
+    if(invalid) {
+        return static_cast<size_t>(count_trailing_zeros(invalid));
+    }
+    return scalar_iso8601_layout_error(str, length, simd_sse2::size);
+}
+#endif
+
+ASCII23_FORCE_INLINE size_t iso8601_layout_error(const char* str, const size_t length) {
+    #if defined(ASCII23_SIMD_SSE2)
+    if(length >= simd_sse2::size) {
+        return simd_iso8601_layout_error(str, length);
+    }
+    #endif
+    return scalar_iso8601_layout_error(str, length, 0);
+}
+
+// Values of the 2-digit numbers starting at each byte of a word, as
+// read by `load_u64_le`. Only valid for bytes followed by a digit.
+// Digits are at most 9, so no byte can carry into the next.
+ASCII23_FORCE_INLINE uint64_t swar_digit_pairs(const uint64_t word) {
+    const uint64_t digits = word & 0x0f0f0f0f0f0f0f0full;
+    return digits * 10 + (digits >> 8);
+}
+
+ASCII23_FORCE_INLINE int byte_at(const uint64_t word, const int index) {
+    return static_cast<int>((word >> (8 * index)) & 0xff);
+}
+
+// Days since 1970-01-01 for a date in the proleptic Gregorian calendar.
+// Years are counted from March, so that the leap day is last.
+ASCII23_FORCE_INLINE int64_t days_from_civil(int year, const int month, const int day) {
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int year_of_era = year - era * 400;
+    const int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int day_of_era = (
+        year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year
+    );
+    return static_cast<int64_t>(era) * 146097 + day_of_era - 719468;
+}
+
+ASCII23_FORCE_INLINE int days_in_month(const int year, const int month) {
+    if(month == 2) {
+        const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return leap ? 29 : 28;
+    }
+    return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+}
+
+ASCII23_FORCE_INLINE parse_iso8601_result iso8601_error(const size_t offset) {
+    parse_iso8601_result result;
+    result.nanoseconds = 0;
+    result.length = 0;
+    result.error = offset;
+    return result;
+}
+
+} // namespace detail
+
+ASCII23_INLINE parse_iso8601_result parse_iso8601(const char* str, const size_t length) {
+    using detail::byte_at;
+    const size_t layout_error = detail::iso8601_layout_error(str, length);
+    if(layout_error != npos) {
+        return detail::iso8601_error(layout_error);
+    }
+    // Fields from three overlapping words: `YYYY-MM-`, `DDTHH:MM`,
+    // and `HH:MM:SS`
+    const uint64_t date = detail::swar_digit_pairs(detail::load_u64_le(str));
+    const uint64_t day_word = detail::swar_digit_pairs(detail::load_u64_le(str + 8));
+    const uint64_t time = detail::swar_digit_pairs(detail::load_u64_le(str + 11));
+    const int year = byte_at(date, 0) * 100 + byte_at(date, 2);
+    const int month = byte_at(date, 5);
+    const int day = byte_at(day_word, 0);
+    const int hour = byte_at(time, 0);
+    const int minute = byte_at(time, 3);
+    const int second = byte_at(time, 6);
+    if(month < 1 || month > 12) {
+        return detail::iso8601_error(5);
+    }
+    if(day < 1 || day > detail::days_in_month(year, month)) {
+        return detail::iso8601_error(8);
+    }
+    if(hour > 23) {
+        return detail::iso8601_error(11);
+    }
+    if(minute > 59) {
+        return detail::iso8601_error(14);
+    }
+    // Allow a leap second
+    if(second > 60) {
+        return detail::iso8601_error(17);
+    }
+    size_t i = detail::ISO8601_LAYOUT_LENGTH;
+    // Fraction of a second
+    int64_t fraction = 0;
+    if(i < length && (str[i] == '.' || str[i] == ',')) {
+        const size_t digits = detail::digit_run_length(str + i + 1, length - i - 1);
+        if(!digits) {
+            return detail::iso8601_error(i + 1);
+        }
+        const size_t used = digits < 9 ? digits : 9;
+        fraction = static_cast<int64_t>(
+            detail::digits_value(str + i + 1, used) *
+            detail::POWERS_OF_10[9 - used]
+        );
+        i += 1 + digits;
+    }
+    // UTC offset
+    int offset_minutes = 0;
+    if(i < length && (str[i] == 'Z' || str[i] == 'z')) {
+        ++i;
+    }
+    else if(i < length && (str[i] == '+' || str[i] == '-')) {
+        const char* zone = str + i + 1;
+        for(size_t j = 0; j < 5; ++j) {
+            const bool valid = (i + 1 + j < length) && (j == 2 ?
+                zone[j] == ':' : is_digit_char(static_cast<unsigned char>(zone[j]))
+            );
+            if(!valid) {
+                return detail::iso8601_error(i + 1 + j);
+            }
+        }
+        const int zone_hours = (zone[0] - '0') * 10 + (zone[1] - '0');
+        const int zone_minutes = (zone[3] - '0') * 10 + (zone[4] - '0');
+        if(zone_hours > 23) {
+            return detail::iso8601_error(i + 1);
+        }
+        else if(zone_minutes > 59) {
+            return detail::iso8601_error(i + 4);
+        }
+        offset_minutes = (zone_hours * 60 + zone_minutes) * (str[i] == '-' ? -1 : 1);
+        i += 6;
+    }
+    const int64_t seconds = (
+        detail::days_from_civil(year, month, day) * 86400 +
+        hour * 3600 + minute * 60 + second - offset_minutes * 60
+    );
+    // Limits of int64 nanoseconds, in whole seconds
+    if(seconds > 9223372035 || seconds < -9223372036) {
+        return detail::iso8601_error(0);
+    }
+    parse_iso8601_result result;
+    result.nanoseconds = seconds * 1000000000 + fraction;
+    result.length = i;
+    result.error = npos;
+    return result;
+}
+
+namespace detail {
+
+// Masks of the digit and `.` bytes in 16 bytes.
+ASCII23_FORCE_INLINE void ipv4_masks(
+    const char* str, uint32_t& digits, uint32_t& dots
+) {
+    #if defined(ASCII23_SIMD_SSE2)
+    const simd_sse2::vec x = simd_sse2::load(str);
+    digits = simd_sse2::mask(simd_sse2::in_range(x, '0', '9'));
+    dots = simd_sse2::mask(simd_sse2::eq(x, simd_sse2::set1('.')));
+    #else
+    digits = 0;
+    dots = 0;
+    for(size_t i = 0; i < 16; ++i) {
+        const unsigned char uch = static_cast<unsigned char>(str[i]);
+        digits |= static_cast<uint32_t>(is_digit_char(uch)) << i;
+        dots |= static_cast<uint32_t>(uch == '.') << i;
+    }
+    #endif
+}
+
+// Value of 1-3 digits. At least 4 bytes must be readable at `str`.
+// The digits are shifted to the end of 3 bytes, after zero bytes.
+ASCII23_FORCE_INLINE uint32_t ipv4_number_value(const char* str, const size_t digits) {
+    uint32_t word;
+    std::memcpy(&word, str, sizeof(word));
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap32(word);
+    #endif
+    word = (word << (8 * (4 - digits))) >> 8;
+    return (
+        (word & 0x0f) * 100 + ((word >> 8) & 0x0f) * 10 + ((word >> 16) & 0x0f)
+    );
+}
+
+ASCII23_FORCE_INLINE parse_ipv4_result ipv4_error(const size_t offset) {
+    parse_ipv4_result result;
+    result.address = 0;
+    result.length = 0;
+    result.error = offset;
+    return result;
+}
+
+// Offsets of the `-` between the groups of digits in a UUID.
+const size_t UUID_DASH_OFFSETS[] = {8, 13, 18, 23};
+
+// Maps an offset in the digits of a UUID to an offset in the UUID.
+ASCII23_FORCE_INLINE size_t uuid_offset(size_t digit_offset) {
+    for(size_t group = 0; group < 4; ++group) {
+        digit_offset += UUID_DASH_OFFSETS[group] <= digit_offset ? 1 : 0;
+    }
+    return digit_offset;
+}
+
+} // namespace detail
+
+ASCII23_INLINE parse_ipv4_result parse_ipv4(const char* str, const size_t length) {
+    // Short inputs are padded with zeros, which end the address
+    char padded[20] = {0};
+    const char* ptr = str;
+    if(length < 20) {
+        std::memcpy(padded, str, length);
+        ptr = padded;
+    }
+    uint32_t digits;
+    uint32_t dots;
+    detail::ipv4_masks(ptr, digits, dots);
+    // Set for every byte that doesn't continue a number
+    const uint32_t number_ends = ~digits;
+    uint32_t address = 0;
+    size_t i = 0;
+    for(size_t part = 0; part < 4; ++part) {
+        const size_t end = static_cast<size_t>(
+            detail::count_trailing_zeros(number_ends >> i)
+        ) + i;
+        const size_t count = end - i;
+        if(count == 0) {
+            return detail::ipv4_error(i);
+        }
+        else if(count > 3) {
+            return detail::ipv4_error(i + 3);
+        }
+        else if(count > 1 && ptr[i] == '0') {
+            return detail::ipv4_error(i);
+        }
+        const uint32_t value = detail::ipv4_number_value(ptr + i, count);
+        if(value > 255) {
+            return detail::ipv4_error(i);
+        }
+        address = (address << 8) | value;
+        if(part < 3) {
+            if(!((dots >> end) & 1)) {
+                return detail::ipv4_error(end);
+            }
+            i = end + 1;
+        }
+        else {
+            i = end;
+        }
+    }
+    parse_ipv4_result result;
+    result.address = address;
+    result.length = i;
+    result.error = npos;
+    return result;
+}
+
+ASCII23_INLINE size_t format_ipv4(const uint32_t address, char* dst) {
+    size_t length = 0;
+    for(int shift = 24; shift >= 0; shift -= 8) {
+        length += format_uint((address >> shift) & 0xff, dst + length);
+        if(shift) {
+            dst[length++] = '.';
+        }
+    }
+    return length;
+}
+
+ASCII23_INLINE size_t parse_uuid(const char* str, const size_t length, char* dst) {
+    // The groups are copied together so that all 32 digits are
+    // validated and decoded by vectors at once
+    char digits[32];
+    size_t copied = 0;
+    size_t start = 0;
+    size_t layout_error = npos;
+    for(size_t group = 0; group < 5; ++group) {
+        const size_t end = group < 4 ? detail::UUID_DASH_OFFSETS[group] : UUID_LENGTH;
+        const size_t available = (end < length ? end : length) - start;
+        std::memcpy(digits + copied, str + start, available);
+        copied += available;
+        if(end > length || (group < 4 && (end == length || str[end] != '-'))) {
+            layout_error = end < length ? end : length;
+            break;
+        }
+        start = end + 1;
+    }
+    if(layout_error != npos) {
+        // Report an invalid digit before the missing dash, if any
+        const size_t invalid = detail::find_first_flags<true>(
+            digits, copied, CHAR_FLAG_HEX_DIGIT
+        );
+        return invalid == npos ? layout_error : detail::uuid_offset(invalid);
+    }
+    const size_t invalid = hex_decode(digits, sizeof(digits), dst);
+    return invalid == npos ? npos : detail::uuid_offset(invalid);
+}
+
+ASCII23_INLINE void format_uuid(const char* src, char* dst, const bool upper) {
+    char digits[32];
+    hex_encode(src, 16, digits, upper);
+    size_t copied = 0;
+    size_t start = 0;
+    for(size_t group = 0; group < 5; ++group) {
+        const size_t end = group < 4 ? detail::UUID_DASH_OFFSETS[group] : UUID_LENGTH;
+        std::memcpy(dst + start, digits + copied, end - start);
+        copied += end - start;
+        if(group < 4) {
+            dst[end] = '-';
+        }
+        start = end + 1;
+    }
+}
+
+namespace detail {
+
+// Alphabets for `base64_encode`.
+const char BASE64_ALPHABET_STANDARD[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char BASE64_ALPHABET_URL[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+#if defined(ASCII23_SIMD_SSSE3)
+// Spreads each 3 input bytes over 4 output bytes, as 16-bit pairs
+// with the bytes swapped, so that each 6-bit group can be shifted
+// into place with a multiply.
+const char BASE64_SPREAD_TABLE[] = {
+    1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+};
+
+// Offsets added to 6-bit values to get characters, indexed by the
+// value minus 51, saturated at 0, or by 13 for values below 26.
+const char BASE64_OFFSETS_STANDARD[] = {
+    'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+};
+const char BASE64_OFFSETS_URL[] = {
+    'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0
+};
+
+// Gathers the 3 bytes packed into each 32-bit value, high byte first.
+const char BASE64_PACK_TABLE[] = {
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+};
+
+// Returns the number of bytes of `src` that were encoded, a multiple
+// of 3. Reads up to `simd::size` bytes past the bytes encoded.
+template<typename simd>
+inline size_t simd_base64_encode(
+    const char* src, const size_t length, char* dst, const char* offsets
+) {
+    typedef typename simd::vec vec;
+    const vec spread = simd::load_lane_table(BASE64_SPREAD_TABLE);
+    const vec offset_table = simd::load_lane_table(offsets);
+    size_t i = 0;
+    for(; i + simd::size <= length; i += simd::size / 4 * 3) {
+        const vec x = simd::shuffle(simd::load_triples(src + i), spread);
+        // Shift the 1st and 3rd groups down, and the 2nd and 4th up
+        const vec high = simd::mulhi_u16(
+            simd::and_(x, simd::set1_u32(0x0fc0fc00)),
+            simd::set1_u32(0x04000040)
+        );
+        const vec low = simd::mullo_u16(
+            simd::and_(x, simd::set1_u32(0x003f03f0)),
+            simd::set1_u32(0x01000010)
+        );
+        const vec values = simd::or_(high, low);
+        const vec index = simd::or_(
+            simd::subs_u8(values, simd::set1(51)),
+            simd::and_(simd::in_range(values, 0, 25), simd::set1(13))
+        );
+        simd::store(dst + i / 3 * 4, simd::add(
+            values, simd::shuffle(offset_table, index)
+        ));
+    }
+    return i;
+}
+
+// Returns the number of bytes of `src` that were decoded, a multiple
+// of 4, stopping before any vector containing a byte that isn't in
+// the alphabet. Sets `invalid` to the offset of that byte, if any.
+// Writes up to `simd::size` bytes past the bytes decoded, so it stops
+// while at least `2 * simd::size` bytes of `src` are left.
+template<typename simd>
+inline size_t simd_base64_decode(
+    const char* src, const size_t length, char* dst,
+    const char char_62, const char char_63, size_t& invalid
+) {
+    typedef typename simd::vec vec;
+    const vec pack = simd::load_lane_table(BASE64_PACK_TABLE);
+    size_t i = 0;
+    for(; i + 2 * simd::size <= length; i += simd::size) {
+        const vec x = simd::load(src + i);
+        const vec upper = simd_flags_mask<simd>(x, CHAR_FLAG_UPPER);
+        const vec lower = simd_flags_mask<simd>(x, CHAR_FLAG_LOWER);
+        const vec digit = simd_flags_mask<simd>(x, CHAR_FLAG_DIGIT);
+        const vec is_62 = simd::eq(x, simd::set1(char_62));
+        const vec is_63 = simd::eq(x, simd::set1(char_63));
+        const vec valid = simd::or_(
+            simd::or_(simd::or_(upper, lower), digit),
+            simd::or_(is_62, is_63)
+        );
+        const uint32_t invalid_bits = ~simd::mask(valid) & simd::all_bits;
+        if(invalid_bits) {
+            invalid = i + count_trailing_zeros(invalid_bits);
+            break;
+        }
+        const vec offsets = simd::or_(
+            simd::or_(
+                simd::and_(upper, simd::set1(-'A')),
+                simd::and_(lower, simd::set1(26 - 'a'))
+            ),
+            simd::or_(
+                simd::and_(digit, simd::set1(52 - '0')),
+                simd::or_(
+                    simd::and_(is_62, simd::set1(62 - char_62)),
+                    simd::and_(is_63, simd::set1(63 - char_63))
+                )
+            )
+        );
+        const vec values = simd::add(x, offsets);
+        // Combine pairs of 6-bit values into 12 bits, then into 24 bits
+        const vec pairs = simd::multiply_add_u8(
+            values, simd::set1_u32(0x01400140)
+        );
+        const vec triples = simd::multiply_add_i16(
+            pairs, simd::set1_u32(0x00011000)
+        );
+        simd::store_triples(dst + i / 4 * 3, simd::shuffle(triples, pack));
+    }
+    return i;
+}
+#endif
+
+// Value of a character in the base64 alphabet, or -1.
+ASCII23_FORCE_INLINE int base64_value(
+    const char ch, const char char_62, const char char_63
+) {
+    const unsigned char uch = static_cast<unsigned char>(ch);
+    const int flags = uch <= 0x7f ? char_flags_array[uch] : 0;
+    if(flags & CHAR_FLAG_UPPER) {
+        return uch - 'A';
+    }
+    else if(flags & CHAR_FLAG_LOWER) {
+        return uch - 'a' + 26;
+    }
+    else if(flags & CHAR_FLAG_DIGIT) {
+        return uch - '0' + 52;
+    }
+    else if(ch == char_62) {
+        return 62;
+    }
+    else if(ch == char_63) {
+        return 63;
+    }
+    return -1;
+}
+
+#if defined(ASCII23_SIMD_SSSE3)
+// Decodes whole vectors of `src`. Returns the number of bytes decoded.
+// Sets `invalid` to the offset of a byte not in the alphabet that
+// stopped decoding, or leaves it unchanged.
+ASCII23_FORCE_INLINE size_t base64_decode_vectors(
+    const char* src, const size_t length, char* dst,
+    const char char_62, const char char_63, size_t& invalid
+) {
+    size_t i = 0;
+    #if defined(ASCII23_SIMD_AVX2)
+    i += simd_base64_decode<simd_avx2>(
+        src, length, dst, char_62, char_63, invalid
+    );
+    #endif
+    const size_t start = i;
+    size_t sse_invalid = npos;
+    i += simd_base64_decode<simd_sse2>(
+        src + i, length - i, dst + i / 4 * 3, char_62, char_63, sse_invalid
+    );
+    if(sse_invalid != npos) {
+        invalid = start + sse_invalid;
+    }
+    return i;
+}
+#endif
+
+} // namespace detail
+
+ASCII23_INLINE size_t base64_encoded_length(const size_t length, const int options) {
+    const size_t remainder = length % 3;
+    const size_t tail = (
+        remainder == 0 ? 0 :
+        (options & BASE64_NO_PADDING) ? remainder + 1 : 4
+    );
+    return length / 3 * 4 + tail;
+}
+
+ASCII23_INLINE size_t base64_encode(const char* src, const size_t length, char* dst, const int options) {
+    const bool url = (options & BASE64_URL) != 0;
+    const char* alphabet = (
+        url ? detail::BASE64_ALPHABET_URL : detail::BASE64_ALPHABET_STANDARD
+    );
+    size_t i = 0;
+    #if defined(ASCII23_SIMD_SSSE3)
+    const char* offsets = (
+        url ? detail::BASE64_OFFSETS_URL : detail::BASE64_OFFSETS_STANDARD
+    );
+    #endif
+    #if defined(ASCII23_SIMD_AVX2)
+    i += detail::simd_base64_encode<detail::simd_avx2>(
+        src, length, dst, offsets
+    );
+    #endif
+    #if defined(ASCII23_SIMD_SSSE3)
+    i += detail::simd_base64_encode<detail::simd_sse2>(
+        src + i, length - i, dst + i / 3 * 4, offsets
+    );
+    #endif
+    size_t out = i / 3 * 4;
+    for(; i + 3 <= length; i += 3) {
+        const uint32_t bits = (
+            (static_cast<uint32_t>(static_cast<unsigned char>(src[i])) << 16) |
+            (static_cast<uint32_t>(static_cast<unsigned char>(src[i + 1])) << 8) |
+            static_cast<uint32_t>(static_cast<unsigned char>(src[i + 2]))
+        );
+        dst[out++] = alphabet[bits >> 18];
+        dst[out++] = alphabet[(bits >> 12) & 0x3f];
+        dst[out++] = alphabet[(bits >> 6) & 0x3f];
+        dst[out++] = alphabet[bits & 0x3f];
+    }
+    if(i < length) {
+        const bool two = i + 2 == length;
+        const uint32_t bits = (
+            (static_cast<uint32_t>(static_cast<unsigned char>(src[i])) << 16) |
+            (two ? static_cast<uint32_t>(static_cast<unsigned char>(src[i + 1])) << 8 : 0)
+        );
+        dst[out++] = alphabet[bits >> 18];
+        dst[out++] = alphabet[(bits >> 12) & 0x3f];
+        if(two) {
+            dst[out++] = alphabet[(bits >> 6) & 0x3f];
+        }
+        if(!(options & BASE64_NO_PADDING)) {
+            dst[out++] = '=';
+            if(!two) {
+                dst[out++] = '=';
+            }
+        }
+    }
+    return out;
+}
+
+ASCII23_INLINE base64_decode_result base64_decode(const char* src, const size_t length, char* dst, const int options) {
+    const bool url = (options & BASE64_URL) != 0;
+    const bool skip_whitespace = (options & BASE64_SKIP_WHITESPACE) != 0;
+    const char char_62 = url ? '-' : '+';
+    const char char_63 = url ? '_' : '/';
+    size_t i = 0;
+    size_t out = 0;
+    // Bits of a partial group of 4 characters
+    uint32_t bits = 0;
+    int count = 0;
+    size_t last = 0;
+    #if defined(ASCII23_SIMD_SSSE3)
+    // Offset after which whole vectors are tried again
+    size_t vectors_from = 0;
+    #endif
+    while(true) {
+        #if defined(ASCII23_SIMD_SSSE3)
+        if(count == 0 && i >= vectors_from) {
+            size_t invalid = npos;
+            const size_t decoded = detail::base64_decode_vectors(
+                src + i, length - i, dst + out, char_62, char_63, invalid
+            );
+            vectors_from = invalid == npos ? length : i + invalid + 1;
+            i += decoded;
+            out += decoded / 4 * 3;
+        }
+        #endif
+        if(i >= length) {
+            break;
+        }
+        const int value = detail::base64_value(src[i], char_62, char_63);
+        if(value >= 0) {
+            bits = (bits << 6) | static_cast<uint32_t>(value);
+            last = i;
+            if(++count == 4) {
+                dst[out++] = static_cast<char>(bits >> 16);
+                dst[out++] = static_cast<char>(bits >> 8);
+                dst[out++] = static_cast<char>(bits);
+                bits = 0;
+                count = 0;
+            }
+        }
+        else if(!(skip_whitespace && is_whitespace_char(static_cast<unsigned char>(src[i])))) {
+            break;
+        }
+        ++i;
+    }
+    base64_decode_result result;
+    result.error = npos;
+    if(i < length && src[i] == '=' && count >= 2) {
+        // Padding must complete the last group, and end the input
+        int padding = 4 - count;
+        for(; i < length && padding > 0; ++i) {
+            if(src[i] == '=') {
+                --padding;
+            }
+            else if(!(skip_whitespace && is_whitespace_char(static_cast<unsigned char>(src[i])))) {
+                break;
+            }
+        }
+        while(skip_whitespace && i < length && is_whitespace_char(static_cast<unsigned char>(src[i]))) {
+            ++i;
+        }
+        if(padding > 0 || i < length) {
+            result.error = i;
+        }
+    }
+    else if(i < length) {
+        result.error = i;
+    }
+    else if(count == 1) {
+        result.error = last;
+    }
+    if(count == 2) {
+        dst[out++] = static_cast<char>(bits >> 4);
+    }
+    else if(count == 3) {
+        dst[out++] = static_cast<char>(bits >> 10);
+        dst[out++] = static_cast<char>(bits >> 2);
+    }
+    result.length = out;
+    return result;
+}
+
+namespace detail {
+
+// Classifies the bytes of a vector by equality with either of two bytes.
+template<typename simd>
+struct simd_byte_pair_classifier {
+    typedef typename simd::vec vec;
+    const vec first;
+    const vec second;
+    simd_byte_pair_classifier(const char first_byte, const char second_byte) :
+        first(simd::set1(first_byte)), second(simd::set1(second_byte)) {}
+    ASCII23_FORCE_INLINE vec operator()(const vec x) const {
+        return simd::or_(simd::eq(x, first), simd::eq(x, second));
+    }
+};
+
+// Classifies single bytes by equality with either of two bytes.
+struct byte_pair_classifier {
+    const char first;
+    const char second;
+    byte_pair_classifier(const char first_byte, const char second_byte) :
+        first(first_byte), second(second_byte) {}
+    ASCII23_FORCE_INLINE bool operator()(const char ch) const {
+        return ch == first || ch == second;
+    }
+};
+
+ASCII23_FORCE_INLINE size_t find_first_byte_pair(
+    const char* str, const size_t length, const char first, const char second
+) {
+    #if defined(ASCII23_SIMD_AVX2)
+    if(length >= simd_avx2::size) {
+        return simd_find_first<simd_avx2, false>(
+            str, length, simd_byte_pair_classifier<simd_avx2>(first, second)
+        );
+    }
+    #endif
+    #if defined(ASCII23_SIMD_SSE2)
+    if(length >= simd_sse2::size) {
+        return simd_find_first<simd_sse2, false>(
+            str, length, simd_byte_pair_classifier<simd_sse2>(first, second)
+        );
+    }
+    #endif
+    return scalar_find_first<false>(
+        str, length, byte_pair_classifier(first, second)
+    );
+}
+
+} // namespace detail
+
+ASCII23_INLINE size_t percent_encoded_length(const char* src, const size_t length, const char_set unreserved) {
+    size_t encoded = length;
+    size_t i = 0;
+    while(true) {
+        const size_t next = detail::find_first_in<true>(
+            src + i, length - i, unreserved
+        );
+        if(next == npos) {
+            return encoded;
+        }
+        encoded += 2;
+        i += next + 1;
+    }
+}
+
+ASCII23_INLINE size_t percent_encode(const char* src, const size_t length, char* dst, const char_set unreserved) {
+    size_t i = 0;
+    size_t out = 0;
+    while(true) {
+        // Copy the run of bytes up to the next one needing an escape
+        const size_t next = detail::find_first_in<true>(
+            src + i, length - i, unreserved
+        );
+        const size_t run = next == npos ? length - i : next;
+        std::memcpy(dst + out, src + i, run);
+        i += run;
+        out += run;
+        if(i >= length) {
+            return out;
+        }
+        const unsigned char uch = static_cast<unsigned char>(src[i++]);
+        dst[out] = '%';
+        dst[out + 1] = detail::HEX_DIGITS_UPPER[uch >> 4];
+        dst[out + 2] = detail::HEX_DIGITS_UPPER[uch & 0x0f];
+        out += 3;
+    }
+}
+
+ASCII23_INLINE percent_decode_result percent_decode(const char* src, const size_t length, char* dst, const bool plus_as_space) {
+    const char escape = '%';
+    const char space = plus_as_space ? '+' : '%';
+    percent_decode_result result;
+    result.error = npos;
+    size_t i = 0;
+    size_t out = 0;
+    while(true) {
+        // Copy the run of bytes up to the next escape, unless decoding
+        // in place with no escapes seen yet
+        const size_t next = detail::find_first_byte_pair(
+            src + i, length - i, escape, space
+        );
+        const size_t run = next == npos ? length - i : next;
+        if(dst + out != src + i) {
+            std::memmove(dst + out, src + i, run);
+        }
+        i += run;
+        out += run;
+        if(i >= length) {
+            break;
+        }
+        if(src[i] != escape) {
+            dst[out++] = ' ';
+            ++i;
+            continue;
+        }
+        const int high = i + 1 < length ? detail::hex_nibble(src[i + 1], HEX_CASE_ANY) : -1;
+        const int low = i + 2 < length ? detail::hex_nibble(src[i + 2], HEX_CASE_ANY) : -1;
+        if(high < 0 || low < 0) {
+            result.error = i;
+            break;
+        }
+        dst[out++] = static_cast<char>((high << 4) | low);
+        i += 3;
+    }
+    result.length = out;
+    return result;
+}
+
+namespace detail {
+
+// Index of the first byte escaped by a table, or `npos`.
+ASCII23_FORCE_INLINE size_t find_first_escaped(
+    const char* str, const size_t length, const escape_table& table
+) {
+    return table.non_ascii ? (
+        find_first_in<true>(str, length, ~table.special)
+    ) : (
+        find_first_in<false>(str, length, table.special)
+    );
+}
+
+// Backslash escapes shared by `ESCAPE_JSON` and `ESCAPE_C`, or 0.
+ASCII23_FORCE_INLINE char short_escape(const unsigned char uch, const int mode) {
+    switch(uch) {
+        case '"': return '"';
+        case '\\': return '\\';
+        case '\b': return 'b';
+        case '\f': return 'f';
+        case '\n': return 'n';
+        case '\r': return 'r';
+        case '\t': return 't';
+        case '\a': return mode == ESCAPE_C ? 'a' : 0;
+        case '\v': return mode == ESCAPE_C ? 'v' : 0;
+        default: return 0;
+    }
+}
+
+// Writes the escape for a byte. Returns the number of bytes written,
+// at most 6.
+ASCII23_FORCE_INLINE size_t write_escape(
+    const unsigned char uch, const int mode, char* dst
+) {
+    if(mode == ESCAPE_HTML) {
+        const char* entity = (
+            uch == '&' ? "&amp;" : uch == '<' ? "&lt;" : uch == '>' ? "&gt;" :
+            uch == '"' ? "&quot;" : "&#39;"
+        );
+        const size_t length = std::strlen(entity);
+        std::memcpy(dst, entity, length);
+        return length;
+    }
+    else if(mode == ESCAPE_CARET) {
+        dst[0] = '^';
+        dst[1] = static_cast<char>(uch ^ 0x40);
+        return 2;
+    }
+    dst[0] = '\\';
+    const char letter = short_escape(uch, mode);
+    if(letter) {
+        dst[1] = letter;
+        return 2;
+    }
+    else if(mode == ESCAPE_JSON) {
+        std::memcpy(dst + 1, "u00", 3);
+        dst[4] = HEX_DIGITS_LOWER[uch >> 4];
+        dst[5] = HEX_DIGITS_LOWER[uch & 0x0f];
+        return 6;
+    }
+    // Octal is used since `\x` would consume any following hex digits
+    dst[1] = static_cast<char>('0' + (uch >> 6));
+    dst[2] = static_cast<char>('0' + ((uch >> 3) & 0x7));
+    dst[3] = static_cast<char>('0' + (uch & 0x7));
+    return 4;
+}
+
+// Length of the escape for a byte, without writing it.
+template<int mode>
+inline size_t mode_escape_length(const unsigned char uch) {
+    if(mode == ESCAPE_HTML) {
+        return uch == '&' || uch == '\'' ? 5 : uch == '"' ? 6 : 4;
+    }
+    else if(mode == ESCAPE_CARET) {
+        return 2;
+    }
+    return short_escape(uch, mode) ? 2 : mode == ESCAPE_JSON ? 6 : 4;
+}
+
+template<int mode>
+inline size_t mode_write_escape(const unsigned char uch, char* dst) {
+    return write_escape(uch, mode, dst);
+}
+
+// For the table that escapes nothing.
+inline size_t copy_length(const unsigned char) {
+    return 1;
+}
+
+inline size_t copy_write(const unsigned char uch, char* dst) {
+    dst[0] = static_cast<char>(uch);
+    return 1;
+}
+
+// Tables for the `ESCAPE_*` modes, followed by one escaping nothing.
+const escape_table ESCAPE_TABLES[] = {
+    {
+        char_set::range(0x00, 0x1f) | char_set("\"\\"), false,
+        mode_escape_length<ESCAPE_JSON>, mode_write_escape<ESCAPE_JSON>
+    },
+    {
+        char_set::range(0x00, 0x1f) | char_set("\"\\\x7f"), true,
+        mode_escape_length<ESCAPE_C>, mode_write_escape<ESCAPE_C>
+    },
+    {
+        char_set("&<>\"'"), false,
+        mode_escape_length<ESCAPE_HTML>, mode_write_escape<ESCAPE_HTML>
+    },
+    {
+        char_set::range(0x00, 0x1f) | char_set("\x7f"), false,
+        mode_escape_length<ESCAPE_CARET>, mode_write_escape<ESCAPE_CARET>
+    },
+    {char_set(), false, copy_length, copy_write},
+};
+
+} // namespace detail
+
+ASCII23_INLINE escape_table get_escape_table(const int mode) {
+    return detail::ESCAPE_TABLES[
+        mode >= ESCAPE_JSON && mode <= ESCAPE_CARET ? mode : ESCAPE_CARET + 1
+    ];
+}
+
+ASCII23_INLINE size_t escaped_length(const char* src, const size_t length, const int mode) {
+    return escaped_length(src, length, get_escape_table(mode));
+}
+
+ASCII23_INLINE size_t escaped_length(const char* src, const size_t length, const escape_table& table) {
+    size_t escaped = length;
+    size_t i = 0;
+    while(true) {
+        const size_t next = detail::find_first_escaped(src + i, length - i, table);
+        if(next == npos) {
+            return escaped;
+        }
+        i += next;
+        escaped += table.length(static_cast<unsigned char>(src[i++])) - 1;
+    }
+}
+
+ASCII23_INLINE size_t escape(const char* src, const size_t length, char* dst, const int mode) {
+    return escape(src, length, dst, get_escape_table(mode));
+}
+
+ASCII23_INLINE size_t escape(const char* src, const size_t length, char* dst, const escape_table& table) {
+    size_t i = 0;
+    size_t out = 0;
+    while(true) {
+        // Copy the run of bytes up to the next one needing an escape
+        const size_t next = detail::find_first_escaped(src + i, length - i, table);
+        const size_t run = next == npos ? length - i : next;
+        std::memcpy(dst + out, src + i, run);
+        i += run;
+        out += run;
+        if(i >= length) {
+            return out;
+        }
+        out += table.write(static_cast<unsigned char>(src[i++]), dst + out);
+    }
+}
+
+namespace detail {
+
+// Writes a code point as UTF-8. Returns the number of bytes written.
+ASCII23_FORCE_INLINE size_t write_utf8(const uint32_t code_point, char* dst) {
+    if(code_point < 0x80) {
+        dst[0] = static_cast<char>(code_point);
+        return 1;
+    }
+    else if(code_point < 0x800) {
+        dst[0] = static_cast<char>(0xc0 | (code_point >> 6));
+        dst[1] = static_cast<char>(0x80 | (code_point & 0x3f));
+        return 2;
+    }
+    else if(code_point < 0x10000) {
+        dst[0] = static_cast<char>(0xe0 | (code_point >> 12));
+        dst[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        dst[2] = static_cast<char>(0x80 | (code_point & 0x3f));
+        return 3;
+    }
+    dst[0] = static_cast<char>(0xf0 | (code_point >> 18));
+    dst[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+    dst[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+    dst[3] = static_cast<char>(0x80 | (code_point & 0x3f));
+    return 4;
+}
+
+// Reads exactly `count` hexadecimal digits at the start of `str`.
+// Returns false if there are fewer.
+ASCII23_FORCE_INLINE bool read_hex_digits(
+    const char* str, const size_t length, const size_t count, uint32_t& value
+) {
+    if(length < count) {
+        return false;
+    }
+    value = 0;
+    for(size_t i = 0; i < count; ++i) {
+        const int digit = hex_digit_value(static_cast<unsigned char>(str[i]));
+        if(digit < 0) {
+            return false;
+        }
+        value = (value << 4) | static_cast<uint32_t>(digit);
+    }
+    return true;
+}
+
+// Decodes an escape sequence of a JSON string, starting with `\`.
+// Returns the number of bytes of `src` consumed, or 0 if malformed.
+// Sets `written` to the number of bytes written to `dst`.
+struct json_unescaper {
+    ASCII23_FORCE_INLINE size_t operator()(
+        const char* src, const size_t length, char* dst, size_t& written
+    ) const {
+        if(length < 2) {
+            return 0;
+        }
+        const char letter = (
+            src[1] == '"' ? '"' : src[1] == '\\' ? '\\' : src[1] == '/' ? '/' :
+            src[1] == 'b' ? '\b' : src[1] == 'f' ? '\f' : src[1] == 'n' ? '\n' :
+            src[1] == 'r' ? '\r' : src[1] == 't' ? '\t' : 0
+        );
+        if(letter) {
+            dst[0] = letter;
+            written = 1;
+            return 2;
+        }
+        uint32_t code_point;
+        if(src[1] != 'u' || !read_hex_digits(src + 2, length - 2, 4, code_point)) {
+            return 0;
+        }
+        size_t consumed = 6;
+        if(code_point >= 0xd800 && code_point <= 0xdfff) {
+            // A high surrogate must be followed by an escaped low surrogate
+            uint32_t low;
+            if(
+                code_point >= 0xdc00 || length < 12 ||
+                src[6] != '\\' || src[7] != 'u' ||
+                !read_hex_digits(src + 8, length - 8, 4, low) ||
+                low < 0xdc00 || low > 0xdfff
+            ) {
+                return 0;
+            }
+            code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+            consumed = 12;
+        }
+        written = write_utf8(code_point, dst);
+        return consumed;
+    }
+};
+
+// Decodes an escape sequence of a C string literal, starting with `\`.
+// Same interface as `json_unescaper`.
+struct c_unescaper {
+    ASCII23_FORCE_INLINE size_t operator()(
+        const char* src, const size_t length, char* dst, size_t& written
+    ) const {
+        if(length < 2) {
+            return 0;
+        }
+        const char letter = (
+            src[1] == '"' ? '"' : src[1] == '\\' ? '\\' : src[1] == '\'' ? '\'' :
+            src[1] == '?' ? '?' : src[1] == 'a' ? '\a' : src[1] == 'b' ? '\b' :
+            src[1] == 'f' ? '\f' : src[1] == 'n' ? '\n' : src[1] == 'r' ? '\r' :
+            src[1] == 't' ? '\t' : src[1] == 'v' ? '\v' : 0
+        );
+        if(letter) {
+            dst[0] = letter;
+            written = 1;
+            return 2;
+        }
+        uint32_t value = 0;
+        size_t i = 1;
+        if(src[1] >= '0' && src[1] <= '7') {
+            for(; i < length && i < 4 && src[i] >= '0' && src[i] <= '7'; ++i) {
+                value = (value << 3) | static_cast<uint32_t>(src[i] - '0');
+            }
+        }
+        else if(src[1] == 'x') {
+            // Any number of digits, but the value must fit in a byte
+            for(i = 2; i < length; ++i) {
+                const int digit = hex_digit_value(static_cast<unsigned char>(src[i]));
+                if(digit < 0) {
+                    break;
+                }
+                value = value > 0xff ? value : (value << 4) | static_cast<uint32_t>(digit);
+            }
+            if(i == 2) {
+                return 0;
+            }
+        }
+        else {
+            const size_t digits = src[1] == 'u' ? 4 : src[1] == 'U' ? 8 : 0;
+            if(
+                !digits || !read_hex_digits(src + 2, length - 2, digits, value) ||
+                value > 0x10ffff || (value >= 0xd800 && value <= 0xdfff)
+            ) {
+                return 0;
+            }
+            written = write_utf8(value, dst);
+            return 2 + digits;
+        }
+        if(value > 0xff) {
+            return 0;
+        }
+        dst[0] = static_cast<char>(value);
+        written = 1;
+        return i;
+    }
+};
+
+template<typename unescaper>
+inline unescape_result unescape(
+    const char* src, const size_t length, char* dst, const unescaper& decode
+) {
+    unescape_result result;
+    result.error = npos;
+    size_t i = 0;
+    size_t out = 0;
+    while(true) {
+        // Copy the run of bytes up to the next escape, unless decoding
+        // in place with no escapes seen yet
+        const size_t next = find_first_byte_pair(src + i, length - i, '\\', '\\');
+        const size_t run = next == npos ? length - i : next;
+        if(dst + out != src + i) {
+            std::memmove(dst + out, src + i, run);
+        }
+        i += run;
+        out += run;
+        if(i >= length) {
+            break;
+        }
+        // Escapes are fully read before writing, so in place is safe
+        size_t written = 0;
+        const size_t consumed = decode(src + i, length - i, dst + out, written);
+        if(!consumed) {
+            result.error = i;
+            break;
+        }
+        i += consumed;
+        out += written;
+    }
+    result.length = out;
+    return result;
+}
+
+} // namespace detail
+
+ASCII23_INLINE unescape_result unescape_json(const char* src, const size_t length, char* dst) {
+    return detail::unescape(src, length, dst, detail::json_unescaper());
+}
+
+ASCII23_INLINE unescape_result unescape_c(const char* src, const size_t length, char* dst) {
+    return detail::unescape(src, length, dst, detail::c_unescaper());
+}
+
+namespace detail {
+
+// Bytes of a vector that `sanitize` replaces or drops are set to 0xff.
+template<typename simd>
+ASCII23_FORCE_INLINE typename simd::vec simd_sanitize_mask(
+    const typename simd::vec x, const bool keep_tab_newline
+) {
+    const typename simd::vec control = simd_flags_mask<simd>(x, CHAR_FLAG_CONTROL);
+    if(!keep_tab_newline) {
+        return control;
+    }
+    return simd::and_not(control, simd::or_(
+        simd::eq(x, simd::set1('\t')), simd::eq(x, simd::set1('\n'))
+    ));
+}
+
+ASCII23_FORCE_INLINE bool is_sanitized(const char ch, const bool keep_tab_newline) {
+    return is_control_char(static_cast<unsigned char>(ch)) && !(
+        keep_tab_newline && (ch == '\t' || ch == '\n')
+    );
+}
+
+// Returns the number of bytes processed, a multiple of the vector size.
+template<typename simd>
+inline size_t simd_sanitize_replace(
+    char* str, const size_t length, const bool keep_tab_newline,
+    const char replacement
+) {
+    typedef typename simd::vec vec;
+    const vec replacements = simd::set1(replacement);
+    size_t i = 0;
+    for(; i + simd::size <= length; i += simd::size) {
+        const vec x = simd::load(str + i);
+        const vec mask = simd_sanitize_mask<simd>(x, keep_tab_newline);
+        if(simd::mask(mask)) {
+            simd::store(str + i, simd::or_(
+                simd::and_not(x, mask), simd::and_(mask, replacements)
+            ));
+        }
+    }
+    return i;
+}
+
+#if defined(ASCII23_SIMD_SSSE3)
+// Advances `i` over whole vectors and `out` over the bytes kept.
+// Nothing is written until the first dropped byte.
+template<typename simd>
+inline void simd_sanitize_drop(
+    char* str, const size_t length, const bool keep_tab_newline,
+    size_t& i, size_t& out
+) {
+    for(; i + simd::size <= length; i += simd::size) {
+        const typename simd::vec x = simd::load(str + i);
+        const uint32_t dropped = simd::mask(
+            simd_sanitize_mask<simd>(x, keep_tab_newline)
+        );
+        if(dropped) {
+            out += simd::store_compacted(str + out, x, ~dropped & simd::all_bits);
+        }
+        else {
+            if(out != i) {
+                simd::store(str + out, x);
+            }
+            out += simd::size;
+        }
+    }
+}
+#endif
+
+} // namespace detail
+
+ASCII23_INLINE size_t sanitize(char* str, const size_t length, const int mode, const char replacement) {
+    const bool keep_tab_newline = (mode & SANITIZE_KEEP_TAB_NEWLINE) != 0;
+    size_t i = 0;
+    if(!(mode & SANITIZE_DROP)) {
+        #if defined(ASCII23_SIMD_AVX2)
+        i += detail::simd_sanitize_replace<detail::simd_avx2>(
+            str, length, keep_tab_newline, replacement
+        );
+        #endif
+        #if defined(ASCII23_SIMD_SSE2)
+        i += detail::simd_sanitize_replace<detail::simd_sse2>(
+            str + i, length - i, keep_tab_newline, replacement
+        );
+        #endif
+        for(; i < length; ++i) {
+            if(detail::is_sanitized(str[i], keep_tab_newline)) {
+                str[i] = replacement;
+            }
+        }
+        return length;
+    }
+    size_t out = 0;
+    #if defined(ASCII23_SIMD_AVX2)
+    detail::simd_sanitize_drop<detail::simd_avx2>(
+        str, length, keep_tab_newline, i, out
+    );
+    #endif
+    #if defined(ASCII23_SIMD_SSSE3)
+    detail::simd_sanitize_drop<detail::simd_sse2>(
+        str, length, keep_tab_newline, i, out
+    );
+    #endif
+    for(; i < length; ++i) {
+        if(!detail::is_sanitized(str[i], keep_tab_newline)) {
+            str[out++] = str[i];
+        }
+    }
+    return out;
+}
+
+namespace detail {
+
+// Length of the escape sequence at the start of `str`, which begins
+// with `ESC`. Always at least 1.
+ASCII23_FORCE_INLINE size_t ansi_sequence_length(const char* str, const size_t length) {
+    if(length < 2) {
+        return length;
+    }
+    const unsigned char introducer = static_cast<unsigned char>(str[1]);
+    size_t i = 2;
+    if(introducer == '[') {
+        // Parameter bytes 0x30-0x3F, intermediate bytes 0x20-0x2F,
+        // then a final byte 0x40-0x7E
+        while(i < length && str[i] >= 0x30 && str[i] <= 0x3f) {
+            ++i;
+        }
+        while(i < length && str[i] >= 0x20 && str[i] <= 0x2f) {
+            ++i;
+        }
+        return i < length && str[i] >= 0x40 && str[i] <= 0x7e ? i + 1 : i;
+    }
+    else if(introducer == ']') {
+        // Printable or non-ASCII text, ended by BEL or `ESC \`
+        for(; i < length; ++i) {
+            const unsigned char uch = static_cast<unsigned char>(str[i]);
+            if(uch == 0x07) {
+                return i + 1;
+            }
+            else if(uch == 0x1b) {
+                return i + 1 < length && str[i + 1] == '\\' ? i + 2 : i;
+            }
+            else if(is_control_char(uch)) {
+                return i;
+            }
+        }
+        return i;
+    }
+    // Intermediate bytes 0x20-0x2F, then a final byte 0x30-0x7E,
+    // e.g. `ESC ( B` to select a character set or `ESC M`
+    i = 1;
+    while(i < length && str[i] >= 0x20 && str[i] <= 0x2f) {
+        ++i;
+    }
+    return i < length && str[i] >= 0x30 && str[i] <= 0x7e ? i + 1 : i;
+}
+
+} // namespace detail
+
+ASCII23_INLINE size_t strip_ansi_sequences(char* str, const size_t length) {
+    size_t i = 0;
+    size_t out = 0;
+    while(true) {
+        // Move the run of bytes up to the next escape, unless nothing
+        // has been removed yet
+        const size_t next = detail::find_first_byte_pair(
+            str + i, length - i, '\x1b', '\x1b'
+        );
+        const size_t run = next == npos ? length - i : next;
+        if(out != i) {
+            std::memmove(str + out, str + i, run);
+        }
+        i += run;
+        out += run;
+        if(i >= length) {
+            return out;
+        }
+        i += detail::ansi_sequence_length(str + i, length - i);
+    }
+}
+
+namespace detail {
+
+#if defined(ASCII23_SIMD_SSSE3)
+// Advances `i` over whole vectors and `out` over the bytes written.
+// `previous` is 1 when the byte before `i` is whitespace, or at the
+// start of the buffer so that leading whitespace is dropped.
+template<typename simd>
+inline void simd_collapse_whitespace(
+    const char* src, const size_t length, char* dst,
+    size_t& i, size_t& out, uint32_t& previous
+) {
+    typedef typename simd::vec vec;
+    const vec spaces = simd::set1(' ');
+    for(; i + simd::size <= length; i += simd::size) {
+        const vec x = simd::load(src + i);
+        const vec whitespace = simd_flags_mask<simd>(x, CHAR_FLAG_WHITESPACE);
+        const uint32_t bits = simd::mask(whitespace);
+        // Whitespace following whitespace is dropped, and the first
+        // byte of each run becomes a space
+        const uint32_t dropped = bits & ((bits << 1) | previous);
+        previous = bits >> (simd::size - 1);
+        const vec spaced = simd::or_(
+            simd::and_not(x, whitespace), simd::and_(whitespace, spaces)
+        );
+        if(dropped) {
+            out += simd::store_compacted(dst + out, spaced, ~dropped & simd::all_bits);
+        }
+        else {
+            if(bits || dst + out != src + i) {
+                simd::store(dst + out, spaced);
+            }
+            out += simd::size;
+        }
+    }
+}
+#endif
+
+} // namespace detail
+
+ASCII23_INLINE size_t collapse_whitespace(char* str, const size_t length) {
+    return collapse_whitespace(str, length, str);
+}
+
+ASCII23_INLINE size_t collapse_whitespace(const char* src, const size_t length, char* dst) {
+    size_t i = 0;
+    size_t out = 0;
+    uint32_t previous = 1;
+    #if defined(ASCII23_SIMD_AVX2)
+    detail::simd_collapse_whitespace<detail::simd_avx2>(
+        src, length, dst, i, out, previous
+    );
+    #endif
+    #if defined(ASCII23_SIMD_SSSE3)
+    detail::simd_collapse_whitespace<detail::simd_sse2>(
+        src, length, dst, i, out, previous
+    );
+    #endif
+    for(; i < length; ++i) {
+        const unsigned char uch = static_cast<unsigned char>(src[i]);
+        const uint32_t whitespace = is_whitespace_char(uch) ? 1 : 0;
+        if(!whitespace) {
+            dst[out++] = static_cast<char>(uch);
+        }
+        else if(!previous) {
+            dst[out++] = ' ';
+        }
+        previous = whitespace;
+    }
+    // Only a run of whitespace can leave a space at the end
+    return out > 0 && previous ? out - 1 : out;
 }
 
 #endif // #if defined(ASCII23_DEFINE_API)
@@ -1,5 +1,11 @@
 #include <ascii23.h>
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #define ANKERL_NANOBENCH_IMPLEMENT
 #include <nanobench.h>
 
@@ -9,6 +15,32 @@
         const auto i = char_fn((ch++) & 0xff); \
         ankerl::nanobench::doNotOptimizeAway(i); \
     });
+
+// Benchmark a statement operating on the whole of `buffer`.
+// Throughput is reported in bytes per second.
+#define BUFFER_BENCHMARK(name, ...) \
+    ankerl::nanobench::Bench().batch(buffer.size()).unit("byte") \
+        .minEpochIterations(2000).run(name, [&] { \
+            __VA_ARGS__; \
+            ankerl::nanobench::doNotOptimizeAway(output); \
+        });
+
+// Build a 64 KiB buffer resembling HTTP headers and log lines, with
+// mixed case, digits, punctuation, whitespace, and some UTF-8.
+std::string make_bench_buffer() {
+    const std::string sample = (
+        "Content-Type: Text/HTML; charset=UTF-8\r\n"
+        "X-Request-Id: 4F9A2C1E-7B3D-4E8F-9A0B-1C2D3E4F5A6B\r\n"
+        "2026-10-17T12:34:56.789Z INFO  Served GET /Index.html in 12ms\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) caf\xc3\xa9 \xe2\x9c\x93\r\n"
+    );
+    std::string buffer;
+    while(buffer.size() < 0x10000) {
+        buffer += sample;
+    }
+    buffer.resize(0x10000);
+    return buffer;
+}
     
 int main() {
     int ch;
@@ -35,5 +67,538 @@ int main() {
     CHAR_BENCHMARK(ascii::is_graphical_char)
     CHAR_BENCHMARK(ascii::to_lower_char)
     CHAR_BENCHMARK(ascii::to_upper_char)
+    
+    const std::string buffer = make_bench_buffer();
+    std::string output(buffer.size(), '\0');
+    BUFFER_BENCHMARK("to_lower_char loop",
+        for(size_t i = 0; i < buffer.size(); ++i) {
+            output[i] = static_cast<char>(ascii::to_lower_char(
+                static_cast<unsigned char>(buffer[i])
+            ));
+        }
+    )
+    BUFFER_BENCHMARK("ascii::to_lower",
+        ascii::to_lower(buffer.data(), buffer.size(), &output[0])
+    )
+    BUFFER_BENCHMARK("ascii::to_upper",
+        ascii::to_upper(buffer.data(), buffer.size(), &output[0])
+    )
+    {
+        // Throughput is measured in hexadecimal digits for both directions
+        std::string hex(2 * buffer.size(), '\0');
+        ascii::hex_encode(buffer.data(), buffer.size(), &hex[0]);
+        BUFFER_BENCHMARK("ascii::hex_encode",
+            ascii::hex_encode(buffer.data(), buffer.size() / 2, &hex[0])
+        )
+        BUFFER_BENCHMARK("ascii::hex_decode",
+            output[0] = static_cast<char>(
+                ascii::hex_decode(hex.data(), buffer.size(), &output[0])
+            )
+        )
+    }
+    BUFFER_BENCHMARK("ascii::class_histogram",
+        const ascii::char_class_histogram histogram = ascii::class_histogram(
+            buffer.data(), buffer.size()
+        );
+        output[0] = static_cast<char>(histogram.word)
+    )
+    BUFFER_BENCHMARK("ascii::classify_block",
+        uint64_t words = 0;
+        for(size_t i = 0; i + 64 <= buffer.size(); i += 64) {
+            const ascii::char_block_masks masks = ascii::classify_block(
+                buffer.data() + i,
+                ascii::CHAR_FLAG_WORD | ascii::CHAR_FLAG_WHITESPACE |
+                ascii::CHAR_FLAG_PUNCTUATION
+            );
+            words ^= masks.word ^ masks.whitespace ^ masks.punctuation;
+        }
+        output[0] = static_cast<char>(words)
+    )
+    BUFFER_BENCHMARK("ascii::classify_block all flags",
+        uint64_t classes = 0;
+        for(size_t i = 0; i + 64 <= buffer.size(); i += 64) {
+            const ascii::char_block_masks masks = ascii::classify_block(
+                buffer.data() + i, -1
+            );
+            classes ^= masks.alpha ^ masks.lower ^ masks.upper ^ masks.digit;
+            classes ^= masks.hex_digit ^ masks.word ^ masks.word_start;
+            classes ^= masks.punctuation ^ masks.whitespace ^ masks.blank;
+            classes ^= masks.control ^ masks.printable ^ masks.graphical;
+            classes ^= masks.non_ascii;
+        }
+        output[0] = static_cast<char>(classes)
+    )
+    {
+        // Split into fields using an output array that fills many times
+        ascii::span tokens[64];
+        BUFFER_BENCHMARK("ascii::tokenize_flags",
+            size_t offset = 0;
+            while(ascii::tokenize_flags(
+                buffer.data(), buffer.size(), offset,
+                ascii::CHAR_FLAG_WHITESPACE, tokens, 64
+            ) == 64) {
+                offset = tokens[63].offset + tokens[63].length;
+            }
+            output[0] = static_cast<char>(offset)
+        )
+        BUFFER_BENCHMARK("ascii::tokenize_in",
+            size_t offset = 0;
+            while(ascii::tokenize_in(
+                buffer.data(), buffer.size(), offset,
+                ascii::char_set(" \t\r\n:;"), tokens, 64
+            ) == 64) {
+                offset = tokens[63].offset + tokens[63].length;
+            }
+            output[0] = static_cast<char>(offset)
+        )
+    }
+    BUFFER_BENCHMARK("is_word_start_char identifier loop",
+        size_t count = 0;
+        size_t i = 0;
+        while(i < buffer.size()) {
+            if(ascii::is_word_start_char(static_cast<unsigned char>(buffer[i]))) {
+                ++count;
+                while(i < buffer.size() && ascii::is_word_char(
+                    static_cast<unsigned char>(buffer[i])
+                )) {
+                    ++i;
+                }
+            }
+            else {
+                ++i;
+            }
+        }
+        output[0] = static_cast<char>(count)
+    )
+    BUFFER_BENCHMARK("ascii::next_identifier",
+        size_t count = 0;
+        size_t offset = 0;
+        while(true) {
+            const ascii::identifier_span id = ascii::next_identifier(
+                buffer.data(), buffer.size(), offset
+            );
+            if(id.offset == ascii::npos) {
+                break;
+            }
+            ++count;
+            offset = id.offset + id.length;
+        }
+        output[0] = static_cast<char>(count)
+    )
+    {
+        std::string upper = buffer;
+        ascii::to_upper(&upper[0], upper.size());
+        BUFFER_BENCHMARK("to_lower_char equality loop",
+            size_t i = 0;
+            while(i < buffer.size() && (
+                ascii::to_lower_char(static_cast<unsigned char>(buffer[i])) ==
+                ascii::to_lower_char(static_cast<unsigned char>(upper[i]))
+            )) {
+                ++i;
+            }
+            output[0] = static_cast<char>(i)
+        )
+        BUFFER_BENCHMARK("ascii::equals_ci",
+            output[0] = ascii::equals_ci(
+                buffer.data(), buffer.size(), upper.data(), upper.size()
+            )
+        )
+        std::string lower = buffer;
+        ascii::to_lower(&lower[0], lower.size());
+        BUFFER_BENCHMARK("ascii::equals_ci_lower",
+            output[0] = ascii::equals_ci_lower(
+                upper.data(), upper.size(), lower.data(), lower.size()
+            )
+        )
+        BUFFER_BENCHMARK("ascii::hash_ci",
+            output[0] = static_cast<char>(
+                ascii::hash_ci(buffer.data(), buffer.size(), 0)
+            )
+        )
+        BUFFER_BENCHMARK("ascii::compare_ci",
+            output[0] = static_cast<char>(ascii::compare_ci(
+                buffer.data(), buffer.size(), upper.data(), upper.size()
+            ))
+        )
+    }
+    {
+        // Integers of varying lengths separated by single spaces
+        std::string buffer;
+        for(uint64_t i = 1; buffer.size() < 0x10000; i = i * 7 + 3) {
+            buffer += std::to_string(i % 100000000000000ull) + " ";
+        }
+        BUFFER_BENCHMARK("strtoull loop",
+            uint64_t sum = 0;
+            const char* ptr = buffer.c_str();
+            const char* end = ptr + buffer.size();
+            while(ptr < end) {
+                char* next;
+                sum += std::strtoull(ptr, &next, 10);
+                ptr = next + 1;
+            }
+            output[0] = static_cast<char>(sum)
+        )
+        BUFFER_BENCHMARK("ascii::parse_uint",
+            uint64_t sum = 0;
+            size_t i = 0;
+            while(i < buffer.size()) {
+                const ascii::parse_uint_result result = ascii::parse_uint(
+                    buffer.data() + i, buffer.size() - i
+                );
+                sum += result.value;
+                i += result.length + 1;
+            }
+            output[0] = static_cast<char>(sum)
+        )
+        int64_t values[256];
+        BUFFER_BENCHMARK("ascii::parse_int_fields_flags",
+            ascii::parse_fields_result result;
+            result.offset = 0;
+            do {
+                result = ascii::parse_int_fields_flags(
+                    buffer.data(), buffer.size(), result.offset,
+                    ascii::CHAR_FLAG_WHITESPACE, values, 256
+                );
+            } while(result.count == 256);
+            output[0] = static_cast<char>(values[0])
+        )
+    }
+    {
+        // Short decimals, like metric values, separated by single spaces
+        std::string buffer;
+        for(uint64_t i = 1; buffer.size() < 0x10000; i = i * 7 + 3) {
+            buffer += std::to_string(i % 100000) + "." + std::to_string(i % 997);
+            buffer += (i & 1) ? " " : "e-3 ";
+        }
+        BUFFER_BENCHMARK("strtod loop",
+            double sum = 0;
+            const char* ptr = buffer.c_str();
+            const char* end = ptr + buffer.size();
+            while(ptr < end) {
+                char* next;
+                sum += std::strtod(ptr, &next);
+                ptr = next + 1;
+            }
+            output[0] = static_cast<char>(sum)
+        )
+        BUFFER_BENCHMARK("ascii::parse_double",
+            double sum = 0;
+            size_t i = 0;
+            while(i < buffer.size()) {
+                const ascii::parse_double_result result = ascii::parse_double(
+                    buffer.data() + i, buffer.size() - i
+                );
+                sum += result.value;
+                i += result.length + 1;
+            }
+            output[0] = static_cast<char>(sum)
+        )
+    }
+    {
+        // Log lines starting with timestamps
+        std::string buffer;
+        for(int i = 0; buffer.size() < 0x10000; ++i) {
+            char line[64];
+            buffer += std::string(line, std::snprintf(line, sizeof(line),
+                "2026-%02d-%02dT%02d:%02d:%02d.%03dZ GET /x\n",
+                1 + i % 12, 1 + i % 28, i % 24, i % 60, (i * 7) % 60, i % 1000
+            ));
+        }
+        BUFFER_BENCHMARK("ascii::parse_iso8601",
+            int64_t sum = 0;
+            for(size_t i = 0; i < buffer.size(); i += 32) {
+                sum += ascii::parse_iso8601(
+                    buffer.data() + i, buffer.size() - i
+                ).nanoseconds;
+            }
+            output[0] = static_cast<char>(sum)
+        )
+    }
+    {
+        // Addresses and UUIDs separated by newlines
+        std::string buffer;
+        std::string uuids;
+        char bytes[16] = {};
+        for(uint32_t i = 1; buffer.size() < 0x10000; i = i * 1664525u + 1013904223u) {
+            char line[ascii::UUID_LENGTH + 1];
+            buffer += std::string(line, ascii::format_ipv4(i >> (i % 24), line)) + "\n";
+            std::memcpy(bytes, &i, sizeof(i));
+            ascii::format_uuid(bytes, line);
+            line[ascii::UUID_LENGTH] = '\n';
+            uuids += std::string(line, sizeof(line));
+        }
+        BUFFER_BENCHMARK("ascii::parse_ipv4",
+            uint32_t sum = 0;
+            size_t i = 0;
+            while(i < buffer.size()) {
+                const ascii::parse_ipv4_result result = ascii::parse_ipv4(
+                    buffer.data() + i, buffer.size() - i
+                );
+                sum += result.address;
+                i += result.length + 1;
+            }
+            output[0] = static_cast<char>(sum)
+        )
+        ankerl::nanobench::Bench().batch(uuids.size()).unit("byte")
+            .minEpochIterations(2000).run("ascii::parse_uuid", [&] {
+                size_t sum = 0;
+                for(size_t i = 0; i < uuids.size(); i += ascii::UUID_LENGTH + 1) {
+                    sum += ascii::parse_uuid(uuids.data() + i, ascii::UUID_LENGTH, bytes);
+                }
+                output[0] = static_cast<char>(sum + bytes[0]);
+                ankerl::nanobench::doNotOptimizeAway(output);
+            });
+    }
+    {
+        // Binary data encoded as base64 with line breaks, as in MIME
+        const std::string binary = make_bench_buffer();
+        std::string encoded(ascii::base64_encoded_length(binary.size()), '\0');
+        ascii::base64_encode(binary.data(), binary.size(), &encoded[0]);
+        std::string wrapped;
+        for(size_t i = 0; i < encoded.size(); i += 76) {
+            wrapped += encoded.substr(i, 76) + "\r\n";
+        }
+        std::string decoded(wrapped.size(), '\0');
+        {
+            const std::string& buffer = binary;
+            BUFFER_BENCHMARK("ascii::base64_encode",
+                output[0] = static_cast<char>(ascii::base64_encode(
+                    buffer.data(), buffer.size(), &encoded[0]
+                ))
+            )
+        }
+        {
+            const std::string& buffer = encoded;
+            BUFFER_BENCHMARK("ascii::base64_decode",
+                output[0] = static_cast<char>(ascii::base64_decode(
+                    buffer.data(), buffer.size(), &decoded[0]
+                ).length)
+            )
+        }
+        {
+            const std::string& buffer = wrapped;
+            BUFFER_BENCHMARK("ascii::base64_decode skip whitespace",
+                output[0] = static_cast<char>(ascii::base64_decode(
+                    buffer.data(), buffer.size(), &decoded[0],
+                    ascii::BASE64_SKIP_WHITESPACE
+                ).length)
+            )
+        }
+    }
+    {
+        // Request paths, mostly without escapes
+        std::string buffer;
+        for(int i = 0; buffer.size() < 0x10000; ++i) {
+            buffer += (
+                i % 8 ? "/api/v2/items/12345/details?fields=name,price" :
+                "/search?q=caf%C3%A9%20menu"
+            );
+        }
+        std::string encoded(3 * buffer.size(), '\0');
+        BUFFER_BENCHMARK("ascii::percent_encode",
+            output[0] = static_cast<char>(ascii::percent_encode(
+                buffer.data(), buffer.size(), &encoded[0]
+            ))
+        )
+        BUFFER_BENCHMARK("ascii::percent_decode",
+            output[0] = static_cast<char>(ascii::percent_decode(
+                buffer.data(), buffer.size(), &encoded[0]
+            ).length)
+        )
+    }
+    {
+        // Escaping the general buffer, with a line break every ~50 bytes
+        std::string escaped(6 * buffer.size(), '\0');
+        BUFFER_BENCHMARK("ascii::escaped_length JSON",
+            output[0] = static_cast<char>(ascii::escaped_length(
+                buffer.data(), buffer.size(), ascii::ESCAPE_JSON
+            ))
+        )
+        BUFFER_BENCHMARK("ascii::escape JSON",
+            output[0] = static_cast<char>(ascii::escape(
+                buffer.data(), buffer.size(), &escaped[0], ascii::ESCAPE_JSON
+            ))
+        )
+        BUFFER_BENCHMARK("ascii::escape HTML",
+            output[0] = static_cast<char>(ascii::escape(
+                buffer.data(), buffer.size(), &escaped[0], ascii::ESCAPE_HTML
+            ))
+        )
+    }
+    {
+        // Unescaping the general buffer after escaping it for JSON
+        std::string escaped(ascii::escaped_length(buffer.data(), buffer.size()), '\0');
+        ascii::escape(buffer.data(), buffer.size(), &escaped[0]);
+        std::string unescaped(escaped.size(), '\0');
+        BUFFER_BENCHMARK("ascii::unescape_json",
+            output[0] = static_cast<char>(ascii::unescape_json(
+                escaped.data(), escaped.size(), &unescaped[0]
+            ).length)
+        )
+    }
+    {
+        // The general buffer with `\r` on most lines, plus some escapes.
+        // Each run copies the input first, since sanitizing is in place.
+        std::string dirty = buffer;
+        for(size_t i = 0; i < dirty.size(); i += 400) {
+            dirty[i] = '\x1b';
+        }
+        std::string sanitized(dirty.size(), '\0');
+        BUFFER_BENCHMARK("ascii::sanitize replace",
+            std::memcpy(&sanitized[0], dirty.data(), dirty.size());
+            output[0] = static_cast<char>(ascii::sanitize(
+                &sanitized[0], sanitized.size(), ascii::SANITIZE_REPLACE
+            ))
+        )
+        BUFFER_BENCHMARK("ascii::sanitize drop",
+            std::memcpy(&sanitized[0], dirty.data(), dirty.size());
+            output[0] = static_cast<char>(ascii::sanitize(
+                &sanitized[0], sanitized.size(),
+                ascii::SANITIZE_DROP | ascii::SANITIZE_KEEP_TAB_NEWLINE
+            ))
+        )
+        BUFFER_BENCHMARK("memcpy baseline",
+            std::memcpy(&sanitized[0], dirty.data(), dirty.size());
+            output[0] = sanitized[1]
+        )
+    }
+    {
+        // Colored compiler and test runner output
+        std::string colored;
+        for(int i = 0; colored.size() < 0x10000; ++i) {
+            colored += (
+                i % 4 ? "\x1b[1msrc/main.cpp:12:5: \x1b[0;1;31merror: \x1b[0m"
+                "\x1b[1mexpected ';' after expression\x1b[0m\n" :
+                "[\x1b[32m       OK \x1b[0m] Suite.Test (12 ms)\n"
+            );
+        }
+        std::string stripped(colored.size(), '\0');
+        const std::string& buffer = colored;
+        BUFFER_BENCHMARK("ascii::strip_ansi_sequences",
+            std::memcpy(&stripped[0], colored.data(), colored.size());
+            output[0] = static_cast<char>(ascii::strip_ansi_sequences(
+                &stripped[0], stripped.size()
+            ))
+        )
+    }
+    {
+        // Prose with irregular whitespace, as extracted from documents
+        std::string prose;
+        const char* words[] = {
+            "the ", "quick  ", "brown\t", "fox\n",
+            "jumps ", "over\r\n\r\n", "a ", "lazy   ",
+        };
+        for(uint32_t i = 1; prose.size() < 0x10000; i = i * 1664525u + 1013904223u) {
+            prose += words[i >> 29];
+        }
+        std::string collapsed(prose.size(), '\0');
+        const std::string& buffer = prose;
+        BUFFER_BENCHMARK("is_whitespace_char collapse loop",
+            size_t out = 0;
+            bool previous = true;
+            for(size_t i = 0; i < buffer.size(); ++i) {
+                const bool whitespace = ascii::is_whitespace_char(buffer[i]);
+                if(!whitespace) {
+                    collapsed[out++] = buffer[i];
+                }
+                else if(!previous) {
+                    collapsed[out++] = ' ';
+                }
+                previous = whitespace;
+            }
+            output[0] = static_cast<char>(out)
+        )
+        BUFFER_BENCHMARK("ascii::collapse_whitespace",
+            output[0] = static_cast<char>(ascii::collapse_whitespace(
+                buffer.data(), buffer.size(), &collapsed[0]
+            ))
+        )
+    }
+    {
+        // Integers of every length, formatted into one output buffer
+        std::vector<uint64_t> values;
+        for(uint64_t i = 1; values.size() < 4096; i = i * 7 + 3) {
+            values.push_back(i >> (values.size() % 64));
+        }
+        ankerl::nanobench::Bench().batch(values.size()).unit("number")
+            .minEpochIterations(200).run("snprintf loop", [&] {
+                char* ptr = &output[0];
+                for(const uint64_t value : values) {
+                    ptr += std::snprintf(ptr, 24, "%llu",
+                        static_cast<unsigned long long>(value)
+                    );
+                }
+                ankerl::nanobench::doNotOptimizeAway(output);
+            });
+        ankerl::nanobench::Bench().batch(values.size()).unit("number")
+            .minEpochIterations(200).run("ascii::format_uint", [&] {
+                char* ptr = &output[0];
+                for(const uint64_t value : values) {
+                    ptr += ascii::format_uint(value, ptr);
+                }
+                ankerl::nanobench::doNotOptimizeAway(output);
+            });
+        ankerl::nanobench::Bench().batch(values.size()).unit("number")
+            .minEpochIterations(200).run("ascii::format_hex", [&] {
+                char* ptr = &output[0];
+                for(const uint64_t value : values) {
+                    ptr += ascii::format_hex(value, ptr);
+                }
+                ankerl::nanobench::doNotOptimizeAway(output);
+            });
+    }
+    {
+        // Validation only scans the whole buffer if it's all ASCII
+        std::string buffer = make_bench_buffer();
+        for(size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i] = static_cast<char>(buffer[i] & 0x7f);
+        }
+        BUFFER_BENCHMARK("ascii::is_all_ascii",
+            output[0] = ascii::is_all_ascii(buffer.data(), buffer.size())
+        )
+        BUFFER_BENCHMARK("ascii::ascii_prefix_length",
+            output[0] = static_cast<char>(
+                ascii::ascii_prefix_length(buffer.data(), buffer.size())
+            )
+        )
+    }
+    {
+        // Searches only scan the whole buffer if there's no early match
+        std::string buffer(make_bench_buffer().size(), ' ');
+        buffer[buffer.size() - 1] = 'x';
+        BUFFER_BENCHMARK("is_whitespace_char loop",
+            size_t i = 0;
+            while(i < buffer.size() && ascii::is_whitespace_char(buffer[i])) {
+                ++i;
+            }
+            output[0] = static_cast<char>(i)
+        )
+        BUFFER_BENCHMARK("ascii::find_first_not_whitespace",
+            output[0] = static_cast<char>(
+                ascii::find_first_not_whitespace(buffer.data(), buffer.size())
+            )
+        )
+        BUFFER_BENCHMARK("ascii::find_first_punctuation",
+            output[0] = static_cast<char>(
+                ascii::find_first_punctuation(buffer.data(), buffer.size())
+            )
+        )
+        BUFFER_BENCHMARK("ascii::find_first_not_in",
+            output[0] = static_cast<char>(ascii::find_first_not_in(
+                buffer.data(), buffer.size(), ascii::char_set(" \t,;")
+            ))
+        )
+        BUFFER_BENCHMARK("ascii::trim",
+            const ascii::span trimmed = ascii::trim(buffer.data(), buffer.size());
+            output[0] = static_cast<char>(trimmed.offset)
+        )
+        buffer[buffer.size() - 1] = ' ';
+        buffer[0] = 'x';
+        BUFFER_BENCHMARK("ascii::find_last_not_blank",
+            output[0] = static_cast<char>(
+                ascii::find_last_not_blank(buffer.data(), buffer.size())
+            )
+        )
+    }
     return 0;
 }
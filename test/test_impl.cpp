@@ -5,7 +5,14 @@
 
 #include <ascii23.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
@@ -538,3 +545,2017 @@ TEST_CASE("to_upper_char") {
     }
     CHECK_CHAR_EPILOGUE
 }
+
+// Maximum buffer length used when testing buffer functions.
+// Long enough to cover several full vectors plus every tail length.
+const size_t TEST_BUFFER_MAX_LENGTH = 200;
+
+// Build a buffer mixing ASCII and non-ASCII bytes, so that buffer
+// functions see every byte value at many positions relative to
+// vector boundaries.
+std::string make_test_buffer(const size_t length, const unsigned seed) {
+    std::string buffer(length, '\0');
+    for(size_t i = 0; i < length; ++i) {
+        buffer[i] = static_cast<char>((i * 37 + seed * 101) & 0xff);
+    }
+    return buffer;
+}
+
+TEST_CASE("to_lower") {
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string src = make_test_buffer(length, length);
+        std::string expect = src;
+        for(size_t i = 0; i < length; ++i) {
+            expect[i] = static_cast<char>(
+                ascii::to_lower_char(static_cast<unsigned char>(src[i]))
+            );
+        }
+        std::string dst(length, '\0');
+        ascii::to_lower(src.data(), length, &dst[0]);
+        CHECK(expect == dst);
+        std::string in_place = src;
+        ascii::to_lower(&in_place[0], length);
+        CHECK(expect == in_place);
+    }
+}
+
+TEST_CASE("to_upper") {
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string src = make_test_buffer(length, length);
+        std::string expect = src;
+        for(size_t i = 0; i < length; ++i) {
+            expect[i] = static_cast<char>(
+                ascii::to_upper_char(static_cast<unsigned char>(src[i]))
+            );
+        }
+        std::string dst(length, '\0');
+        ascii::to_upper(src.data(), length, &dst[0]);
+        CHECK(expect == dst);
+        std::string in_place = src;
+        ascii::to_upper(&in_place[0], length);
+        CHECK(expect == in_place);
+    }
+}
+
+// Build a buffer of only ASCII bytes, cycling through all of them.
+std::string make_ascii_test_buffer(const size_t length, const unsigned seed) {
+    std::string buffer(length, '\0');
+    for(size_t i = 0; i < length; ++i) {
+        buffer[i] = static_cast<char>((i * 37 + seed * 101) & 0x7f);
+    }
+    return buffer;
+}
+
+TEST_CASE("is_all_ascii") {
+    CHECK(ascii::is_all_ascii("", 0));
+    CHECK(ascii::is_all_ascii("hello\x7f", 6));
+    CHECK(!ascii::is_all_ascii("caf\xc3\xa9", 5));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        std::string buffer = make_ascii_test_buffer(length, length);
+        CHECK(ascii::is_all_ascii(buffer.data(), length));
+        for(size_t i = 0; i < length; ++i) {
+            buffer[i] = static_cast<char>(0x80 | i);
+            CHECK(!ascii::is_all_ascii(buffer.data(), length));
+            buffer[i] = 'x';
+        }
+    }
+}
+
+TEST_CASE("ascii_prefix_length") {
+    CHECK(0 == ascii::ascii_prefix_length("", 0));
+    CHECK(3 == ascii::ascii_prefix_length("caf\xc3\xa9", 5));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        std::string buffer = make_ascii_test_buffer(length, length);
+        CHECK(length == ascii::ascii_prefix_length(buffer.data(), length));
+        for(size_t i = 0; i < length; ++i) {
+            buffer[i] = static_cast<char>(0x80 | i);
+            CHECK(i == ascii::ascii_prefix_length(buffer.data(), length));
+            // Only the first non-ASCII byte matters
+            if(i + 1 < length) {
+                buffer[length - 1] = '\xff';
+                CHECK(i == ascii::ascii_prefix_length(buffer.data(), length));
+                buffer[length - 1] = 'x';
+            }
+            buffer[i] = 'x';
+        }
+    }
+}
+
+// Signature shared by the find_first_*, find_last_*, etc. functions.
+typedef size_t (*find_fn)(const char* str, const size_t length);
+
+// Reference implementation for checking find functions.
+size_t find_reference(
+    const std::string& buffer, bool (*char_fn)(const int),
+    const bool expect, const bool last
+) {
+    size_t found = ascii::npos;
+    for(size_t i = 0; i < buffer.size(); ++i) {
+        if(char_fn(static_cast<unsigned char>(buffer[i])) == expect) {
+            found = i;
+            if(!last) {
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+// Check the four find functions for a character class against the
+// class's char function, for every buffer length up to the maximum
+// and with a lone matching or non-matching byte at every position.
+void check_find_fns(
+    bool (*char_fn)(const int),
+    find_fn find_first, find_fn find_first_not,
+    find_fn find_last, find_fn find_last_not
+) {
+    char match = 0;
+    char no_match = 0;
+    for(int i = 0xff; i >= 0; --i) {
+        (char_fn(i) ? match : no_match) = static_cast<char>(i);
+    }
+    REQUIRE(char_fn(static_cast<unsigned char>(match)));
+    REQUIRE(!char_fn(static_cast<unsigned char>(no_match)));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string mixed = make_test_buffer(length, length);
+        CHECK(find_reference(mixed, char_fn, true, false) ==
+            find_first(mixed.data(), length));
+        CHECK(find_reference(mixed, char_fn, false, false) ==
+            find_first_not(mixed.data(), length));
+        CHECK(find_reference(mixed, char_fn, true, true) ==
+            find_last(mixed.data(), length));
+        CHECK(find_reference(mixed, char_fn, false, true) ==
+            find_last_not(mixed.data(), length));
+        std::string none(length, no_match);
+        std::string all(length, match);
+        CHECK(ascii::npos == find_first(none.data(), length));
+        CHECK(ascii::npos == find_last(none.data(), length));
+        CHECK(ascii::npos == find_first_not(all.data(), length));
+        CHECK(ascii::npos == find_last_not(all.data(), length));
+        for(size_t i = 0; i < length; ++i) {
+            none[i] = match;
+            all[i] = no_match;
+            CHECK(i == find_first(none.data(), length));
+            CHECK(i == find_last(none.data(), length));
+            CHECK(i == find_first_not(all.data(), length));
+            CHECK(i == find_last_not(all.data(), length));
+            none[i] = no_match;
+            all[i] = match;
+        }
+    }
+}
+
+// Test the four find functions for one character class.
+#define CHECK_FIND_FNS(class_name) \
+    check_find_fns( \
+        ascii::is_##class_name##_char, \
+        ascii::find_first_##class_name, \
+        ascii::find_first_not_##class_name, \
+        ascii::find_last_##class_name, \
+        ascii::find_last_not_##class_name \
+    );
+
+TEST_CASE("find_alpha") { CHECK_FIND_FNS(alpha) }
+TEST_CASE("find_alpha_lower") { CHECK_FIND_FNS(alpha_lower) }
+TEST_CASE("find_alpha_upper") { CHECK_FIND_FNS(alpha_upper) }
+TEST_CASE("find_digit") { CHECK_FIND_FNS(digit) }
+TEST_CASE("find_hex_digit") { CHECK_FIND_FNS(hex_digit) }
+TEST_CASE("find_word") { CHECK_FIND_FNS(word) }
+TEST_CASE("find_word_start") { CHECK_FIND_FNS(word_start) }
+TEST_CASE("find_punctuation") { CHECK_FIND_FNS(punctuation) }
+TEST_CASE("find_whitespace") { CHECK_FIND_FNS(whitespace) }
+TEST_CASE("find_blank") { CHECK_FIND_FNS(blank) }
+TEST_CASE("find_control") { CHECK_FIND_FNS(control) }
+TEST_CASE("find_printable") { CHECK_FIND_FNS(printable) }
+TEST_CASE("find_graphical") { CHECK_FIND_FNS(graphical) }
+
+TEST_CASE("find_flags") {
+    const int flags = ascii::CHAR_FLAG_DIGIT | ascii::CHAR_FLAG_PUNCTUATION;
+    const std::string text = "hello world, 42 times   ";
+    CHECK(11 == ascii::find_first_flags(text.data(), text.size(), flags));
+    CHECK(14 == ascii::find_last_flags(text.data(), text.size(), flags));
+    CHECK(0 == ascii::find_first_not_flags(text.data(), text.size(), flags));
+    CHECK(23 == ascii::find_last_not_flags(text.data(), text.size(), flags));
+    CHECK(ascii::npos == ascii::find_first_flags(text.data(), 11, flags));
+    CHECK(ascii::npos == ascii::find_first_flags(text.data(), 5, 0));
+    CHECK(ascii::npos == ascii::find_last_not_flags(
+        "\t\n  \r", 5, ascii::CHAR_FLAG_WHITESPACE
+    ));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string mixed = make_test_buffer(length, length);
+        size_t expect_first = ascii::npos;
+        size_t expect_last = ascii::npos;
+        for(size_t i = 0; i < length; ++i) {
+            const unsigned char ch = static_cast<unsigned char>(mixed[i]);
+            if(ch <= 0x7f && (ascii::char_flags_array[ch] & flags)) {
+                expect_first = expect_first == ascii::npos ? i : expect_first;
+                expect_last = i;
+            }
+        }
+        CHECK(expect_first == ascii::find_first_flags(mixed.data(), length, flags));
+        CHECK(expect_last == ascii::find_last_flags(mixed.data(), length, flags));
+    }
+}
+
+TEST_CASE("class_histogram") {
+    const ascii::char_class_histogram empty = ascii::class_histogram("", 0);
+    CHECK(0 == empty.alpha);
+    CHECK(0 == empty.control);
+    CHECK(0 == empty.non_ascii);
+    const std::string text = "Hello_World 42!\t\r\ncaf\xc3\xa9";
+    const ascii::char_class_histogram simple = ascii::class_histogram(
+        text.data(), text.size()
+    );
+    CHECK(13 == simple.alpha);
+    CHECK(11 == simple.lower);
+    CHECK(2 == simple.upper);
+    CHECK(2 == simple.digit);
+    CHECK(7 == simple.hex_digit);
+    CHECK(16 == simple.word);
+    CHECK(14 == simple.word_start);
+    CHECK(2 == simple.punctuation);
+    CHECK(4 == simple.whitespace);
+    CHECK(2 == simple.blank);
+    CHECK(3 == simple.control);
+    CHECK(18 == simple.printable);
+    CHECK(17 == simple.graphical);
+    CHECK(2 == simple.non_ascii);
+    // Long enough to flush the byte counters of the vectorized loop
+    const size_t lengths[] = {
+        0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200,
+        16 * 255 - 1, 16 * 255, 32 * 255 + 1, 32 * 256 * 3 + 7,
+    };
+    for(size_t n = 0; n < sizeof(lengths) / sizeof(lengths[0]); ++n) {
+        const size_t length = lengths[n];
+        const std::string buffer = make_test_buffer(length, length);
+        uint64_t expect[14] = {};
+        for(size_t i = 0; i < length; ++i) {
+            const unsigned char ch = static_cast<unsigned char>(buffer[i]);
+            const int flags = ch <= 0x7f ? ascii::char_flags_array[ch] : 0;
+            for(int bit = 0; bit < 13; ++bit) {
+                expect[bit] += (flags >> bit) & 1;
+            }
+            expect[13] += ch > 0x7f;
+        }
+        const ascii::char_class_histogram histogram = ascii::class_histogram(
+            buffer.data(), length
+        );
+        CHECK(expect[0] == histogram.alpha);
+        CHECK(expect[1] == histogram.lower);
+        CHECK(expect[2] == histogram.upper);
+        CHECK(expect[3] == histogram.digit);
+        CHECK(expect[4] == histogram.hex_digit);
+        CHECK(expect[5] == histogram.word);
+        CHECK(expect[6] == histogram.word_start);
+        CHECK(expect[7] == histogram.punctuation);
+        CHECK(expect[8] == histogram.whitespace);
+        CHECK(expect[9] == histogram.blank);
+        CHECK(expect[10] == histogram.control);
+        CHECK(expect[11] == histogram.printable);
+        CHECK(expect[12] == histogram.graphical);
+        CHECK(expect[13] == histogram.non_ascii);
+    }
+}
+
+// Compute a block mask one byte at a time, using char_flags_array.
+uint64_t block_mask_reference(const char* block, const int flags) {
+    uint64_t mask = 0;
+    for(size_t i = 0; i < ascii::CLASSIFY_BLOCK_SIZE; ++i) {
+        const unsigned char ch = static_cast<unsigned char>(block[i]);
+        if(ch <= 0x7f && (ascii::char_flags_array[ch] & flags)) {
+            mask |= static_cast<uint64_t>(1) << i;
+        }
+    }
+    return mask;
+}
+
+TEST_CASE("classify_block") {
+    const std::string buffer = make_test_buffer(0x200, 3);
+    for(size_t offset = 0; offset + 64 <= buffer.size(); offset += 7) {
+        const char* block = buffer.data() + offset;
+        const ascii::char_block_masks masks = ascii::classify_block(block, -1);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_ALPHA) == masks.alpha);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_LOWER) == masks.lower);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_UPPER) == masks.upper);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_DIGIT) == masks.digit);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_HEX_DIGIT) == masks.hex_digit);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_WORD) == masks.word);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_WORD_START) == masks.word_start);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_PUNCTUATION) == masks.punctuation);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_WHITESPACE) == masks.whitespace);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_BLANK) == masks.blank);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_CONTROL) == masks.control);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_PRINTABLE) == masks.printable);
+        CHECK(block_mask_reference(block, ascii::CHAR_FLAG_GRAPHICAL) == masks.graphical);
+        uint64_t non_ascii = 0;
+        for(size_t i = 0; i < 64; ++i) {
+            non_ascii |= static_cast<uint64_t>(block[i] & 0x80 ? 1 : 0) << i;
+        }
+        CHECK(non_ascii == masks.non_ascii);
+    }
+    // Masks for flags that weren't requested are zero
+    const ascii::char_block_masks digits = ascii::classify_block(
+        buffer.data(), ascii::CHAR_FLAG_DIGIT
+    );
+    CHECK(0 != digits.digit);
+    CHECK(0 == digits.alpha);
+    CHECK(0 == digits.whitespace);
+    // Requesting flags from both halves of the flag bits
+    const ascii::char_block_masks all = ascii::classify_block(buffer.data(), -1);
+    const ascii::char_block_masks some = ascii::classify_block(
+        buffer.data(),
+        ascii::CHAR_FLAG_UPPER | ascii::CHAR_FLAG_PUNCTUATION |
+        ascii::CHAR_FLAG_BLANK | ascii::CHAR_FLAG_GRAPHICAL
+    );
+    CHECK(all.upper == some.upper);
+    CHECK(all.punctuation == some.punctuation);
+    CHECK(all.blank == some.blank);
+    CHECK(all.graphical == some.graphical);
+    CHECK(all.non_ascii == some.non_ascii);
+    CHECK(0 == some.lower);
+    CHECK(0 == some.control);
+}
+
+TEST_CASE("classify_block_flags") {
+    const int flags_list[] = {
+        ascii::CHAR_FLAG_NONE,
+        ascii::CHAR_FLAG_WHITESPACE | ascii::CHAR_FLAG_PUNCTUATION,
+        ascii::CHAR_FLAG_DIGIT | ascii::CHAR_FLAG_UPPER,
+        ascii::CHAR_FLAG_CONTROL | ascii::CHAR_FLAG_WORD_START,
+        -1,
+    };
+    const std::string buffer = make_test_buffer(0x200, 5);
+    for(size_t n = 0; n < sizeof(flags_list) / sizeof(flags_list[0]); ++n) {
+        for(size_t offset = 0; offset + 64 <= buffer.size(); offset += 11) {
+            const char* block = buffer.data() + offset;
+            CHECK(block_mask_reference(block, flags_list[n]) ==
+                ascii::classify_block_flags(block, flags_list[n]));
+        }
+    }
+    const std::string text = (
+        "key = value, other_key = 0x1F; # comment \t\r\n the very last line..."
+    );
+    REQUIRE(text.size() >= 64);
+    const uint64_t spaces = ascii::classify_block_flags(
+        text.data(), ascii::CHAR_FLAG_WHITESPACE
+    );
+    CHECK(0 == (spaces & 1));
+    CHECK(0 != (spaces & (1 << 3)));
+}
+
+TEST_CASE("char_set") {
+    constexpr ascii::char_set empty;
+    constexpr ascii::char_set vowels("aeiouAEIOU");
+    constexpr ascii::char_set lower = ascii::char_set::range('a', 'z');
+    constexpr ascii::char_set unreserved = (
+        ascii::char_set::range('a', 'z') | ascii::char_set::range('A', 'Z') |
+        ascii::char_set::range('0', '9') | ascii::char_set("-._~")
+    );
+    static_assert(vowels.contains('e'), "char_set must be constexpr");
+    static_assert(!vowels.contains('x'), "char_set must be constexpr");
+    for(int ch = -300; ch <= 0x1ff; ++ch) {
+        CHECK(!empty.contains(ch));
+        CHECK((~empty).contains(ch) == ascii::is_char(ch));
+        CHECK(lower.contains(ch) == ascii::is_alpha_lower_char(ch));
+        CHECK((~lower).contains(ch) == (
+            ascii::is_char(ch) && !ascii::is_alpha_lower_char(ch)
+        ));
+        CHECK((lower & vowels).contains(ch) == (
+            ch == 'a' || ch == 'e' || ch == 'i' || ch == 'o' || ch == 'u'
+        ));
+        CHECK(unreserved.contains(ch) == (
+            ascii::is_alpha_char(ch) || ascii::is_digit_char(ch) ||
+            ch == '-' || ch == '.' || ch == '_' || ch == '~'
+        ));
+    }
+    CHECK(ascii::char_set("\x00\x7f\xff") == ascii::char_set("\x7f\x00"));
+    CHECK(ascii::char_set::range(0, 0x7f) == ~empty);
+    CHECK(ascii::char_set::range(0, 0xff) == ~empty);
+    CHECK(ascii::char_set::range('z', 'a') == empty);
+    CHECK(lower != vowels);
+}
+
+TEST_CASE("char_set_from_flags") {
+    const int flags_list[] = {
+        ascii::CHAR_FLAG_NONE,
+        ascii::CHAR_FLAG_WHITESPACE,
+        ascii::CHAR_FLAG_HEX_DIGIT | ascii::CHAR_FLAG_PUNCTUATION,
+        -1,
+    };
+    for(size_t n = 0; n < sizeof(flags_list) / sizeof(flags_list[0]); ++n) {
+        const ascii::char_set set = ascii::char_set_from_flags(flags_list[n]);
+        for(int ch = -1; ch <= 0xff; ++ch) {
+            CHECK(set.contains(ch) == (
+                ascii::is_char(ch) && (ascii::char_flags_array[ch] & flags_list[n])
+            ));
+        }
+    }
+}
+
+// char_set equivalents of the character classes, for check_find_fns.
+const ascii::char_set TEST_TCHAR_SET = (
+    ascii::char_set::range('a', 'z') | ascii::char_set::range('A', 'Z') |
+    ascii::char_set::range('0', '9') | ascii::char_set("!#$%&'*+-.^_`|~")
+);
+bool is_test_tchar(const int ch) {
+    return TEST_TCHAR_SET.contains(ch);
+}
+size_t find_first_test_tchar(const char* str, const size_t length) {
+    return ascii::find_first_in(str, length, TEST_TCHAR_SET);
+}
+size_t find_first_not_test_tchar(const char* str, const size_t length) {
+    return ascii::find_first_not_in(str, length, TEST_TCHAR_SET);
+}
+size_t find_last_test_tchar(const char* str, const size_t length) {
+    return ascii::find_last_in(str, length, TEST_TCHAR_SET);
+}
+size_t find_last_not_test_tchar(const char* str, const size_t length) {
+    return ascii::find_last_not_in(str, length, TEST_TCHAR_SET);
+}
+
+TEST_CASE("find_in") {
+    check_find_fns(
+        is_test_tchar,
+        find_first_test_tchar, find_first_not_test_tchar,
+        find_last_test_tchar, find_last_not_test_tchar
+    );
+    const ascii::char_set csv_delimiters(",;\t\n");
+    const std::string row = "name,age;city\tcountry\n";
+    CHECK(4 == ascii::find_first_in(row.data(), row.size(), csv_delimiters));
+    CHECK(21 == ascii::find_last_in(row.data(), row.size(), csv_delimiters));
+    CHECK(ascii::npos == ascii::find_first_in(row.data(), 4, csv_delimiters));
+    CHECK(ascii::npos == ascii::find_first_in(row.data(), row.size(), ascii::char_set()));
+}
+
+TEST_CASE("all_in") {
+    const ascii::char_set base64(
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/="
+    );
+    CHECK(ascii::all_in("", 0, ascii::char_set()));
+    CHECK(ascii::all_in("SGVsbG8gd29ybGQ=", 16, base64));
+    CHECK(!ascii::all_in("SGVsbG8gd29ybGQ=\n", 17, base64));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        std::string buffer(length, 'Q');
+        CHECK(ascii::all_in(buffer.data(), length, base64));
+        for(size_t i = 0; i < length; ++i) {
+            buffer[i] = (i & 1) ? '\xc3' : '-';
+            CHECK(!ascii::all_in(buffer.data(), length, base64));
+            buffer[i] = 'Q';
+        }
+    }
+}
+
+// Reference implementation for checking compare_ci.
+int compare_ci_reference(const std::string& a, const std::string& b) {
+    for(size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        const int a_ch = ascii::to_lower_char(static_cast<unsigned char>(a[i]));
+        const int b_ch = ascii::to_lower_char(static_cast<unsigned char>(b[i]));
+        if(a_ch != b_ch) {
+            return a_ch < b_ch ? -1 : +1;
+        }
+    }
+    return a.size() < b.size() ? -1 : a.size() > b.size() ? +1 : 0;
+}
+
+// Reduce a comparison result to -1, 0, or +1.
+int sign(const int value) {
+    return value < 0 ? -1 : value > 0 ? +1 : 0;
+}
+
+TEST_CASE("equals_ci") {
+    CHECK(ascii::equals_ci("", 0, "", 0));
+    CHECK(ascii::equals_ci("Content-Type", 12, "content-type", 12));
+    CHECK(!ascii::equals_ci("Content-Type", 12, "content-typ", 11));
+    CHECK(!ascii::equals_ci("[", 1, "{", 1));
+    CHECK(!ascii::equals_ci("caf\xc3\xa9", 5, "CAF\xc3\x89", 5));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string a = make_test_buffer(length, length);
+        std::string b = a;
+        ascii::to_upper(&b[0], length);
+        CHECK(ascii::equals_ci(a.data(), length, b.data(), length));
+        for(size_t i = 0; i < length; ++i) {
+            // Differ by the 0x20 bit, in a way that isn't a case change
+            const char ch = b[i];
+            b[i] = static_cast<char>(ch ^ (ascii::is_alpha_char(ch) ? 0x01 : 0x20));
+            CHECK(!ascii::equals_ci(a.data(), length, b.data(), length));
+            b[i] = ch;
+        }
+    }
+}
+
+TEST_CASE("equals_ci_lower") {
+    CHECK(ascii::equals_ci_lower("", 0, "", 0));
+    CHECK(ascii::equals_ci_lower("Keep-Alive", 10, "keep-alive", 10));
+    CHECK(!ascii::equals_ci_lower("Keep-Alive", 10, "Keep-Alive", 10));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        std::string lower = make_test_buffer(length, length);
+        ascii::to_lower(&lower[0], length);
+        std::string upper = lower;
+        ascii::to_upper(&upper[0], length);
+        CHECK(ascii::equals_ci_lower(upper.data(), length, lower.data(), length));
+        for(size_t i = 0; i < length; ++i) {
+            const char ch = upper[i];
+            upper[i] = static_cast<char>(ch ^ 0x40);
+            CHECK(!ascii::equals_ci_lower(upper.data(), length, lower.data(), length));
+            upper[i] = ch;
+        }
+    }
+}
+
+TEST_CASE("compare_ci") {
+    CHECK(0 == ascii::compare_ci("", 0, "", 0));
+    CHECK(0 == ascii::compare_ci("Hello", 5, "hELLO", 5));
+    CHECK(0 > ascii::compare_ci("apple", 5, "Banana", 6));
+    CHECK(0 < ascii::compare_ci("Cherry", 6, "banana", 6));
+    CHECK(0 > ascii::compare_ci("abc", 3, "ABCD", 4));
+    CHECK(0 < ascii::compare_ci("abcd", 4, "ABC", 3));
+    // Like strcasecmp, letters are compared as lower case,
+    // so '_' (0x5f) is ordered before both 'Z' and 'z'
+    CHECK(0 > ascii::compare_ci("_", 1, "Z", 1));
+    CHECK(0 < ascii::compare_ci("\xff", 1, "a", 1));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string a = make_test_buffer(length, length);
+        std::string b = a;
+        ascii::to_upper(&b[0], length);
+        CHECK(0 == ascii::compare_ci(a.data(), length, b.data(), length));
+        for(size_t i = 0; i < length; ++i) {
+            const char ch = b[i];
+            b[i] = static_cast<char>(ch + 1);
+            CHECK(compare_ci_reference(a, b) ==
+                sign(ascii::compare_ci(a.data(), length, b.data(), length)));
+            CHECK(compare_ci_reference(b, a) ==
+                sign(ascii::compare_ci(b.data(), length, a.data(), length)));
+            CHECK(-1 == sign(ascii::compare_ci(a.data(), i, b.data(), length)));
+            b[i] = ch;
+        }
+    }
+}
+
+TEST_CASE("starts_with_ci") {
+    CHECK(ascii::starts_with_ci("", 0, "", 0));
+    CHECK(ascii::starts_with_ci("abc", 3, "", 0));
+    CHECK(ascii::starts_with_ci("HTTP/1.1 200 OK", 15, "http/", 5));
+    CHECK(!ascii::starts_with_ci("HTTP/1.1 200 OK", 15, "https", 5));
+    CHECK(!ascii::starts_with_ci("HTTP", 4, "http/", 5));
+    const std::string str = make_test_buffer(TEST_BUFFER_MAX_LENGTH, 7);
+    std::string upper = str;
+    ascii::to_upper(&upper[0], upper.size());
+    for(size_t length = 0; length <= str.size(); ++length) {
+        CHECK(ascii::starts_with_ci(str.data(), str.size(), upper.data(), length));
+        if(length > 0) {
+            upper[length - 1] ^= 0x40;
+            CHECK(!ascii::starts_with_ci(str.data(), str.size(), upper.data(), length));
+            upper[length - 1] ^= 0x40;
+        }
+    }
+}
+
+TEST_CASE("ends_with_ci") {
+    CHECK(ascii::ends_with_ci("", 0, "", 0));
+    CHECK(ascii::ends_with_ci("abc", 3, "", 0));
+    CHECK(ascii::ends_with_ci("index.HTML", 10, ".html", 5));
+    CHECK(!ascii::ends_with_ci("index.htm", 9, ".html", 5));
+    CHECK(!ascii::ends_with_ci("html", 4, ".html", 5));
+    const std::string str = make_test_buffer(TEST_BUFFER_MAX_LENGTH, 7);
+    std::string upper = str;
+    ascii::to_upper(&upper[0], upper.size());
+    for(size_t length = 0; length <= str.size(); ++length) {
+        const char* suffix = upper.data() + upper.size() - length;
+        CHECK(ascii::ends_with_ci(str.data(), str.size(), suffix, length));
+        if(length > 0) {
+            upper[upper.size() - length] ^= 0x40;
+            CHECK(!ascii::ends_with_ci(str.data(), str.size(), suffix, length));
+            upper[upper.size() - length] ^= 0x40;
+        }
+    }
+}
+
+TEST_CASE("hash_ci") {
+    // Known values, which must be the same with and without SIMD
+    CHECK(0xef46db3751d8e999ull == ascii::hash_ci("", 0, 0));
+    CHECK(0x597c55e166fe33f7ull == ascii::hash_ci("hello", 5, 0));
+    CHECK(0x597c55e166fe33f7ull == ascii::hash_ci("HeLLo", 5, 0));
+    CHECK(0x9849628ec4ea1601ull == ascii::hash_ci("hello", 5, 1));
+    CHECK(0x993a54c55509016eull == ascii::hash_ci("Content-Type", 12, 0));
+    const std::string fox = "The Quick Brown Fox Jumps Over The Lazy Dog";
+    CHECK(0xed714233c5a9a792ull == ascii::hash_ci(fox.data(), fox.size(), 0));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string buffer = make_test_buffer(length, length);
+        std::string lower = buffer;
+        ascii::to_lower(&lower[0], length);
+        std::string upper = buffer;
+        ascii::to_upper(&upper[0], length);
+        const uint64_t hash = ascii::hash_ci(buffer.data(), length, 0);
+        CHECK(hash == ascii::hash_ci(lower.data(), length, 0));
+        CHECK(hash == ascii::hash_ci(upper.data(), length, 0));
+        CHECK(hash != ascii::hash_ci(buffer.data(), length, 1));
+        if(length > 0) {
+            CHECK(hash != ascii::hash_ci(buffer.data(), length - 1, 0));
+            upper[length - 1] ^= 0x01;
+            CHECK(hash != ascii::hash_ci(upper.data(), length, 0));
+        }
+    }
+}
+
+TEST_CASE("hash_ci_fn and equal_ci_fn") {
+    std::unordered_map<std::string, int, ascii::hash_ci_fn, ascii::equal_ci_fn> headers;
+    headers["Content-Type"] = 1;
+    headers["content-length"] = 2;
+    headers["CONTENT-TYPE"] = 3;
+    CHECK(2 == headers.size());
+    CHECK(3 == headers["content-type"]);
+    CHECK(2 == headers.at("Content-Length"));
+    CHECK(headers.end() == headers.find("Content-Encoding"));
+}
+
+// Get the part of a buffer referred to by a span.
+std::string span_str(const std::string& str, const ascii::span span) {
+    REQUIRE(span.offset + span.length <= str.size());
+    return str.substr(span.offset, span.length);
+}
+
+TEST_CASE("trim") {
+    const std::string value = " \t value with  spaces\t\r\n";
+    CHECK("value with  spaces" == span_str(value, ascii::trim(value.data(), value.size())));
+    CHECK("value with  spaces\t\r\n" == span_str(value, ascii::ltrim(value.data(), value.size())));
+    CHECK(" \t value with  spaces" == span_str(value, ascii::rtrim(value.data(), value.size())));
+    const int blank = ascii::CHAR_FLAG_BLANK;
+    CHECK("value with  spaces\t\r\n" == span_str(value, ascii::trim(value.data(), value.size(), blank)));
+    CHECK("value with  spaces\t\r\n" == span_str(value, ascii::ltrim(value.data(), value.size(), blank)));
+    CHECK(value == span_str(value, ascii::rtrim(value.data(), value.size(), blank)));
+    // Empty and all-whitespace buffers
+    const std::string spaces = " \t\r\n\v\f ";
+    CHECK(spaces.size() == ascii::trim(spaces.data(), spaces.size()).offset);
+    CHECK(0 == ascii::trim(spaces.data(), spaces.size()).length);
+    CHECK(spaces.size() == ascii::ltrim(spaces.data(), spaces.size()).offset);
+    CHECK(0 == ascii::rtrim(spaces.data(), spaces.size()).offset);
+    CHECK(0 == ascii::rtrim(spaces.data(), spaces.size()).length);
+    CHECK(0 == ascii::trim("", 0).length);
+    // Non-ASCII bytes are never trimmed
+    const std::string utf8 = "\xc2\xa0 x \xc2\xa0";
+    CHECK(utf8 == span_str(utf8, ascii::trim(utf8.data(), utf8.size())));
+    // Padding of every length on both sides
+    for(size_t pad = 0; pad <= TEST_BUFFER_MAX_LENGTH / 2; ++pad) {
+        for(size_t inner = 0; inner <= 40; inner += 7) {
+            const std::string content = inner ? "x" + std::string(inner, ' ') + "y" : "z";
+            const std::string padded = (
+                std::string(pad, ' ') + content + std::string(pad / 2 + 1, '\t')
+            );
+            CHECK(content == span_str(padded, ascii::trim(padded.data(), padded.size())));
+            CHECK(content + std::string(pad / 2 + 1, '\t') ==
+                span_str(padded, ascii::ltrim(padded.data(), padded.size())));
+            CHECK(std::string(pad, ' ') + content ==
+                span_str(padded, ascii::rtrim(padded.data(), padded.size())));
+        }
+    }
+}
+
+// Reference implementation for `tokenize_flags` and `tokenize_in`.
+std::vector<ascii::span> tokenize_reference(
+    const std::string& str, const ascii::char_set delimiters
+) {
+    std::vector<ascii::span> tokens;
+    size_t i = 0;
+    while(i < str.size()) {
+        while(i < str.size() && delimiters.contains(str[i] & 0xff)) {
+            ++i;
+        }
+        const size_t start = i;
+        while(i < str.size() && !delimiters.contains(str[i] & 0xff)) {
+            ++i;
+        }
+        if(i > start) {
+            ascii::span token;
+            token.offset = start;
+            token.length = i - start;
+            tokens.push_back(token);
+        }
+    }
+    return tokens;
+}
+
+// Tokenize a string using an output array with room for `max_tokens`,
+// resuming until all tokens have been found.
+template<typename tokenize_fn>
+std::vector<ascii::span> tokenize_all(
+    const std::string& str, const size_t max_tokens, const tokenize_fn& tokenize
+) {
+    std::vector<ascii::span> tokens;
+    std::vector<ascii::span> output(max_tokens);
+    size_t offset = 0;
+    while(true) {
+        const size_t count = tokenize(str, offset, output.data(), max_tokens);
+        REQUIRE(count <= max_tokens);
+        tokens.insert(tokens.end(), output.begin(), output.begin() + count);
+        if(count < max_tokens) {
+            return tokens;
+        }
+        offset = output[count - 1].offset + output[count - 1].length;
+    }
+}
+
+void check_tokens(
+    const std::vector<ascii::span>& expected,
+    const std::vector<ascii::span>& actual
+) {
+    REQUIRE(expected.size() == actual.size());
+    for(size_t i = 0; i < expected.size(); ++i) {
+        CHECK(expected[i].offset == actual[i].offset);
+        CHECK(expected[i].length == actual[i].length);
+    }
+}
+
+TEST_CASE("tokenize") {
+    const std::string line = "  GET /index.html\tHTTP/1.1 200  ";
+    ascii::span tokens[8];
+    REQUIRE(4 == ascii::tokenize_flags(
+        line.data(), line.size(), 0, ascii::CHAR_FLAG_WHITESPACE, tokens, 8
+    ));
+    CHECK("GET" == line.substr(tokens[0].offset, tokens[0].length));
+    CHECK("/index.html" == line.substr(tokens[1].offset, tokens[1].length));
+    CHECK("HTTP/1.1" == line.substr(tokens[2].offset, tokens[2].length));
+    CHECK("200" == line.substr(tokens[3].offset, tokens[3].length));
+    REQUIRE(4 == ascii::tokenize_in(
+        line.data(), line.size(), 0, ascii::char_set(" /"), tokens, 8
+    ));
+    CHECK("GET" == line.substr(tokens[0].offset, tokens[0].length));
+    CHECK("index.html\tHTTP" == line.substr(tokens[1].offset, tokens[1].length));
+    CHECK("1.1" == line.substr(tokens[2].offset, tokens[2].length));
+    CHECK("200" == line.substr(tokens[3].offset, tokens[3].length));
+    // Resuming when the output is full
+    REQUIRE(2 == ascii::tokenize_flags(
+        line.data(), line.size(), 0, ascii::CHAR_FLAG_WHITESPACE, tokens, 2
+    ));
+    CHECK("/index.html" == line.substr(tokens[1].offset, tokens[1].length));
+    REQUIRE(2 == ascii::tokenize_flags(
+        line.data(), line.size(), tokens[1].offset + tokens[1].length,
+        ascii::CHAR_FLAG_WHITESPACE, tokens, 2
+    ));
+    CHECK("HTTP/1.1" == line.substr(tokens[0].offset, tokens[0].length));
+    CHECK("200" == line.substr(tokens[1].offset, tokens[1].length));
+    CHECK(0 == ascii::tokenize_flags(
+        line.data(), line.size(), tokens[1].offset + tokens[1].length,
+        ascii::CHAR_FLAG_WHITESPACE, tokens, 2
+    ));
+    CHECK(0 == ascii::tokenize_flags(
+        line.data(), line.size(), 0, ascii::CHAR_FLAG_WHITESPACE, tokens, 0
+    ));
+    CHECK(0 == ascii::tokenize_flags("", 0, 0, ascii::CHAR_FLAG_WHITESPACE, tokens, 8));
+    // Compare with the reference for many buffers and output sizes
+    const ascii::char_set whitespace = ascii::char_set_from_flags(
+        ascii::CHAR_FLAG_WHITESPACE
+    );
+    const ascii::char_set delimiters(" ,;\t");
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        for(size_t seed = 0; seed < 3; ++seed) {
+            std::string buffer = make_test_buffer(length, seed);
+            for(size_t i = 0; i < length; i += 1 + (i % 5)) {
+                buffer[i] = (i & 1) ? ' ' : ',';
+            }
+            const std::vector<ascii::span> expected_whitespace = (
+                tokenize_reference(buffer, whitespace)
+            );
+            const std::vector<ascii::span> expected_delimiters = (
+                tokenize_reference(buffer, delimiters)
+            );
+            const size_t max_tokens[] = {1, 2, 3, 17, 1000};
+            for(size_t max : max_tokens) {
+                check_tokens(expected_whitespace, tokenize_all(buffer, max,
+                    [](const std::string& str, size_t offset, ascii::span* tokens, size_t max) {
+                        return ascii::tokenize_flags(
+                            str.data(), str.size(), offset,
+                            ascii::CHAR_FLAG_WHITESPACE, tokens, max
+                        );
+                    }
+                ));
+                check_tokens(expected_delimiters, tokenize_all(buffer, max,
+                    [&](const std::string& str, size_t offset, ascii::span* tokens, size_t max) {
+                        return ascii::tokenize_in(
+                            str.data(), str.size(), offset, delimiters, tokens, max
+                        );
+                    }
+                ));
+            }
+        }
+    }
+}
+
+// Reference implementation for `next_identifier`.
+ascii::identifier_span next_identifier_reference(
+    const std::string& str, const size_t offset
+) {
+    ascii::identifier_span result = {ascii::npos, 0, ascii::IDENTIFIER_CASE_NONE};
+    for(size_t i = offset; i < str.size(); ++i) {
+        const bool after_word = i > 0 && ascii::is_word_char(str[i - 1] & 0xff);
+        if(!after_word && ascii::is_word_start_char(str[i] & 0xff)) {
+            result.offset = i;
+            break;
+        }
+    }
+    if(result.offset == ascii::npos) {
+        return result;
+    }
+    size_t i = result.offset;
+    for(; i < str.size() && ascii::is_word_char(str[i] & 0xff); ++i) {
+        if(ascii::is_alpha_lower_char(str[i])) {
+            result.letter_case |= ascii::IDENTIFIER_CASE_LOWER;
+        }
+        if(ascii::is_alpha_upper_char(str[i])) {
+            result.letter_case |= ascii::IDENTIFIER_CASE_UPPER;
+        }
+    }
+    result.length = i - result.offset;
+    return result;
+}
+
+TEST_CASE("scan_identifier") {
+    const char* sql = "select_1 FROM Users_2 where";
+    CHECK(8 == ascii::scan_identifier(sql, 27).length);
+    CHECK(ascii::IDENTIFIER_CASE_LOWER == ascii::scan_identifier(sql, 27).letter_case);
+    CHECK(4 == ascii::scan_identifier(sql + 9, 18).length);
+    CHECK(ascii::IDENTIFIER_CASE_UPPER == ascii::scan_identifier(sql + 9, 18).letter_case);
+    CHECK(7 == ascii::scan_identifier(sql + 14, 13).length);
+    CHECK(ascii::IDENTIFIER_CASE_MIXED == ascii::scan_identifier(sql + 14, 13).letter_case);
+    CHECK(3 == ascii::scan_identifier(sql, 3).length);
+    CHECK(0 == ascii::scan_identifier(sql + 8, 19).length);
+    CHECK(0 == ascii::scan_identifier("1abc", 4).length);
+    CHECK(0 == ascii::scan_identifier("", 0).length);
+    CHECK(4 == ascii::scan_identifier("__1_", 4).length);
+    CHECK(ascii::IDENTIFIER_CASE_NONE == ascii::scan_identifier("__1_", 4).letter_case);
+    const std::string long_identifier = std::string(100, 'x') + "Y + z";
+    CHECK(101 == ascii::scan_identifier(long_identifier.data(), long_identifier.size()).length);
+    CHECK(ascii::IDENTIFIER_CASE_MIXED == ascii::scan_identifier(
+        long_identifier.data(), long_identifier.size()
+    ).letter_case);
+}
+
+TEST_CASE("next_identifier") {
+    const std::string expr = "  12px + width*2 - (ITEM_count)";
+    ascii::identifier_span id = ascii::next_identifier(expr.data(), expr.size(), 0);
+    CHECK("width" == expr.substr(id.offset, id.length));
+    CHECK(ascii::IDENTIFIER_CASE_LOWER == id.letter_case);
+    id = ascii::next_identifier(expr.data(), expr.size(), id.offset + id.length);
+    CHECK("ITEM_count" == expr.substr(id.offset, id.length));
+    CHECK(ascii::IDENTIFIER_CASE_MIXED == id.letter_case);
+    id = ascii::next_identifier(expr.data(), expr.size(), id.offset + id.length);
+    CHECK(ascii::npos == id.offset);
+    CHECK(0 == id.length);
+    CHECK(ascii::npos == ascii::next_identifier("", 0, 0).offset);
+    // Compare with the reference for buffers with many identifiers
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        for(size_t seed = 0; seed < 3; ++seed) {
+            std::string buffer = make_test_buffer(length, seed);
+            for(size_t i = 0; i < length; ++i) {
+                if(buffer[i] & 0x10) {
+                    buffer[i] = "aZ_5"[(i ^ seed) & 3];
+                }
+            }
+            size_t offset = 0;
+            while(true) {
+                const ascii::identifier_span expected = (
+                    next_identifier_reference(buffer, offset)
+                );
+                const ascii::identifier_span actual = (
+                    ascii::next_identifier(buffer.data(), buffer.size(), offset)
+                );
+                CHECK(expected.offset == actual.offset);
+                CHECK(expected.length == actual.length);
+                CHECK(expected.letter_case == actual.letter_case);
+                if(expected.offset == ascii::npos || actual.offset == ascii::npos) {
+                    break;
+                }
+                const ascii::identifier_span scanned = ascii::scan_identifier(
+                    buffer.data() + actual.offset, buffer.size() - actual.offset
+                );
+                CHECK(expected.length == scanned.length);
+                CHECK(expected.letter_case == scanned.letter_case);
+                offset = actual.offset + 1 + (actual.length / 2);
+            }
+        }
+    }
+}
+
+TEST_CASE("hex_encode") {
+    char hex[64];
+    ascii::hex_encode("\x01\xab\xff\x7f", 4, hex);
+    CHECK(std::string(hex, 8) == "01abff7f");
+    ascii::hex_encode("\x01\xab\xff\x7f", 4, hex, true);
+    CHECK(std::string(hex, 8) == "01ABFF7F");
+    ascii::hex_encode("", 0, hex);
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string buffer = make_test_buffer(length, length);
+        std::string expected_lower;
+        std::string expected_upper;
+        for(size_t i = 0; i < length; ++i) {
+            const int uch = buffer[i] & 0xff;
+            expected_lower += "0123456789abcdef"[uch >> 4];
+            expected_lower += "0123456789abcdef"[uch & 0xf];
+            expected_upper += "0123456789ABCDEF"[uch >> 4];
+            expected_upper += "0123456789ABCDEF"[uch & 0xf];
+        }
+        std::string encoded(2 * length, '\0');
+        ascii::hex_encode(buffer.data(), length, &encoded[0]);
+        CHECK(expected_lower == encoded);
+        ascii::hex_encode(buffer.data(), length, &encoded[0], true);
+        CHECK(expected_upper == encoded);
+    }
+}
+
+TEST_CASE("hex_decode") {
+    char bytes[64];
+    CHECK(ascii::npos == ascii::hex_decode("01abFF7f", 8, bytes));
+    CHECK(std::string(bytes, 4) == "\x01\xab\xff\x7f");
+    CHECK(ascii::npos == ascii::hex_decode("", 0, bytes));
+    CHECK(4 == ascii::hex_decode("01abFF7f", 8, bytes, ascii::HEX_CASE_LOWER));
+    CHECK(2 == ascii::hex_decode("01abFF7f", 8, bytes, ascii::HEX_CASE_UPPER));
+    CHECK(ascii::npos == ascii::hex_decode("01ABFF7F", 8, bytes, ascii::HEX_CASE_UPPER));
+    CHECK(1 == ascii::hex_decode("0g", 2, bytes));
+    CHECK(0 == ascii::hex_decode("g0", 2, bytes));
+    CHECK(4 == ascii::hex_decode("01ab7", 5, bytes));
+    CHECK(std::string(bytes, 2) == "\x01\xab");
+    CHECK(2 == ascii::hex_decode("01 ab", 5, bytes));
+    for(size_t length = 0; length <= TEST_BUFFER_MAX_LENGTH; ++length) {
+        const std::string buffer = make_test_buffer(length, length);
+        std::string lower(2 * length, '\0');
+        std::string upper(2 * length, '\0');
+        ascii::hex_encode(buffer.data(), length, &lower[0]);
+        ascii::hex_encode(buffer.data(), length, &upper[0], true);
+        std::string decoded(length, '\0');
+        CHECK(ascii::npos == ascii::hex_decode(lower.data(), lower.size(), &decoded[0]));
+        CHECK(buffer == decoded);
+        CHECK(ascii::npos == ascii::hex_decode(upper.data(), upper.size(), &decoded[0]));
+        CHECK(buffer == decoded);
+        CHECK(ascii::npos == ascii::hex_decode(
+            lower.data(), lower.size(), &decoded[0], ascii::HEX_CASE_LOWER
+        ));
+        CHECK(buffer == decoded);
+        // The first invalid byte is reported at every position
+        for(size_t i = 0; i < lower.size(); i += 1 + (i % 7)) {
+            std::string invalid = lower;
+            invalid[i] = (i & 1) ? 'g' : '\xc3';
+            CHECK(i == ascii::hex_decode(invalid.data(), invalid.size(), &decoded[0]));
+            CHECK(buffer.substr(0, i / 2) == decoded.substr(0, i / 2));
+            CHECK(i == ascii::hex_decode(
+                invalid.data(), invalid.size(), &decoded[0], ascii::HEX_CASE_LOWER
+            ));
+        }
+        // Strict case modes reject the first letter of the other case
+        const size_t first_letter = lower.find_first_of("abcdef");
+        if(first_letter != std::string::npos) {
+            CHECK(first_letter == ascii::hex_decode(
+                lower.data(), lower.size(), &decoded[0], ascii::HEX_CASE_UPPER
+            ));
+            CHECK(first_letter == ascii::hex_decode(
+                upper.data(), upper.size(), &decoded[0], ascii::HEX_CASE_LOWER
+            ));
+        }
+        if(length) {
+            CHECK(lower.size() - 2 == ascii::hex_decode(
+                lower.data(), lower.size() - 1, &decoded[0]
+            ));
+        }
+    }
+}
+
+TEST_CASE("digit_value") {
+    for(int ch = 0; ch < 0x100; ++ch) {
+        CHECK(ascii::digit_value(ch) == (ascii::is_digit_char(ch) ? ch - '0' : -1));
+        CHECK((ascii::hex_digit_value(ch) >= 0) == ascii::is_hex_digit_char(ch));
+        CHECK(ascii::hex_digit_value(ch) == ascii::radix_digit_value(ch, 16));
+        for(int base = 2; base <= 36; ++base) {
+            const int value = ascii::radix_digit_value(ch, base);
+            CHECK(value < base);
+            if(value >= 0) {
+                CHECK(ascii::is_word_char(ch));
+                CHECK("0123456789abcdefghijklmnopqrstuvwxyz"[value] == ascii::to_lower_char(ch));
+            }
+        }
+    }
+    CHECK(10 == ascii::hex_digit_value('a'));
+    CHECK(15 == ascii::hex_digit_value('F'));
+    CHECK(-1 == ascii::hex_digit_value('g'));
+    CHECK(1 == ascii::radix_digit_value('1', 2));
+    CHECK(-1 == ascii::radix_digit_value('2', 2));
+    CHECK(35 == ascii::radix_digit_value('Z', 36));
+    CHECK(-1 == ascii::radix_digit_value('_', 36));
+}
+
+TEST_CASE("parse_uint") {
+    const std::string tests[] = {
+        "0", "7", "12345678", "123456789", "0000000000000000000000042",
+        "18446744073709551615", "9876543210x", "1234567812345678 ",
+    };
+    for(const std::string& test : tests) {
+        const ascii::parse_uint_result result = ascii::parse_uint(test.data(), test.size());
+        CHECK(std::strtoull(test.c_str(), nullptr, 10) == result.value);
+        CHECK(test.find_first_not_of("0123456789") == (
+            result.length == test.size() ? std::string::npos : result.length
+        ));
+        CHECK(!result.overflow);
+    }
+    const std::string max = "18446744073709551615";
+    for(size_t length = 0; length <= max.size(); ++length) {
+        CHECK(std::strtoull(max.substr(0, length).c_str(), nullptr, 10) == (
+            ascii::parse_uint(max.data(), length).value
+        ));
+    }
+    ascii::parse_uint_result result = ascii::parse_uint("18446744073709551616!", 21);
+    CHECK(result.overflow);
+    CHECK(20 == result.length);
+    CHECK(UINT64_MAX == result.value);
+    result = ascii::parse_uint("123456789012345678901234567890", 30);
+    CHECK(result.overflow);
+    CHECK(30 == result.length);
+    CHECK(0 == ascii::parse_uint("", 0).length);
+    CHECK(0 == ascii::parse_uint("x1", 2).length);
+    CHECK(0 == ascii::parse_uint("+1", 2).length);
+    CHECK(0 == ascii::parse_uint("1", 1, 1).length);
+    CHECK(0 == ascii::parse_uint("1", 1, 37).length);
+    CHECK(0xdeadBEEFull == ascii::parse_uint("deadBEEFg", 9, 16).value);
+    CHECK(8 == ascii::parse_uint("deadBEEFg", 9, 16).length);
+    CHECK(5 == ascii::parse_uint("101012", 6, 2).length);
+    CHECK(21 == ascii::parse_uint("101012", 6, 2).value);
+    CHECK(UINT64_MAX == ascii::parse_uint("3w5e11264sgsf", 13, 36).value);
+    CHECK(!ascii::parse_uint("3w5e11264sgsf", 13, 36).overflow);
+    CHECK(ascii::parse_uint("3w5e11264sgsg", 13, 36).overflow);
+    // Compare with strtoull for many digit strings
+    for(size_t length = 1; length <= 20; ++length) {
+        for(size_t seed = 0; seed < 20; ++seed) {
+            std::string digits;
+            for(size_t i = 0; i < length; ++i) {
+                digits += static_cast<char>('0' + (i * 7 + seed * 13 + i * seed) % 10);
+            }
+            const ascii::parse_uint_result parsed = ascii::parse_uint(
+                digits.data(), digits.size()
+            );
+            errno = 0;
+            const unsigned long long expected = std::strtoull(digits.c_str(), nullptr, 10);
+            CHECK(expected == parsed.value);
+            CHECK((errno == ERANGE) == parsed.overflow);
+            CHECK(length == parsed.length);
+        }
+    }
+}
+
+TEST_CASE("parse_int") {
+    ascii::parse_int_result result = ascii::parse_int("-9223372036854775808", 20);
+    CHECK(INT64_MIN == result.value);
+    CHECK(20 == result.length);
+    CHECK(!result.overflow);
+    result = ascii::parse_int("-9223372036854775809", 20);
+    CHECK(INT64_MIN == result.value);
+    CHECK(result.overflow);
+    result = ascii::parse_int("+9223372036854775807", 20);
+    CHECK(INT64_MAX == result.value);
+    CHECK(!result.overflow);
+    result = ascii::parse_int("9223372036854775808", 19);
+    CHECK(INT64_MAX == result.value);
+    CHECK(19 == result.length);
+    CHECK(result.overflow);
+    CHECK(-42 == ascii::parse_int("-42,", 4).value);
+    CHECK(3 == ascii::parse_int("-42,", 4).length);
+    CHECK(-255 == ascii::parse_int("-ff", 3, 16).value);
+    CHECK(0 == ascii::parse_int("-", 1).length);
+    CHECK(0 == ascii::parse_int("+x", 2).length);
+    CHECK(0 == ascii::parse_int("--1", 3).length);
+    CHECK(0 == ascii::parse_int(" 1", 2).length);
+    CHECK(0 == ascii::parse_int("", 0).length);
+    CHECK(-12345678901234 == ascii::parse_int("-000012345678901234", 19).value);
+}
+
+TEST_CASE("parse_int_fields") {
+    const std::string csv = "1,-22,333\n4444,+5,-0\n";
+    const ascii::char_set delimiters(",\n");
+    int64_t values[16];
+    ascii::parse_fields_result result = ascii::parse_int_fields_in(
+        csv.data(), csv.size(), 0, delimiters, values, 16
+    );
+    CHECK(6 == result.count);
+    CHECK(csv.size() == result.offset);
+    CHECK(!result.invalid);
+    CHECK(1 == values[0]);
+    CHECK(-22 == values[1]);
+    CHECK(333 == values[2]);
+    CHECK(4444 == values[3]);
+    CHECK(5 == values[4]);
+    CHECK(0 == values[5]);
+    // Resuming when the output is full
+    result = ascii::parse_int_fields_in(csv.data(), csv.size(), 0, delimiters, values, 4);
+    CHECK(4 == result.count);
+    CHECK(15 == result.offset);
+    result = ascii::parse_int_fields_in(
+        csv.data(), csv.size(), result.offset, delimiters, values, 4
+    );
+    CHECK(2 == result.count);
+    CHECK(5 == values[0]);
+    CHECK(!result.invalid);
+    // Stopping at invalid fields
+    const std::string tsv = "10\t20\t3x\t40";
+    result = ascii::parse_int_fields_flags(
+        tsv.data(), tsv.size(), 0, ascii::CHAR_FLAG_BLANK, values, 16
+    );
+    CHECK(2 == result.count);
+    CHECK(6 == result.offset);
+    CHECK(result.invalid);
+    // Empty fields are invalid, rather than merged with their neighbors
+    const std::string empty_cell = "1,,3\n4,5,6\n";
+    result = ascii::parse_int_fields_in(
+        empty_cell.data(), empty_cell.size(), 0, delimiters, values, 16
+    );
+    CHECK(1 == result.count);
+    CHECK(2 == result.offset);
+    CHECK(result.invalid);
+    result = ascii::parse_int_fields_in("1,2,\n", 5, 0, delimiters, values, 16);
+    CHECK(2 == result.count);
+    CHECK(4 == result.offset);
+    CHECK(result.invalid);
+    result = ascii::parse_int_fields_in(",1", 2, 0, delimiters, values, 16);
+    CHECK(0 == result.count);
+    CHECK(0 == result.offset);
+    CHECK(result.invalid);
+    // Delimiters found by the vectorized scan, after the first vectors
+    std::string row;
+    for(int i = 0; i < 40; ++i) {
+        row += std::to_string(i) + ",";
+    }
+    const std::string wide = row + ",7\n";
+    int64_t row_values[64];
+    result = ascii::parse_int_fields_in(
+        wide.data(), wide.size(), 0, delimiters, row_values, 64
+    );
+    CHECK(40 == result.count);
+    CHECK(row.size() == result.offset);
+    CHECK(result.invalid);
+    CHECK(39 == row_values[39]);
+    const std::string big = "1 99999999999999999999 3";
+    result = ascii::parse_int_fields_flags(
+        big.data(), big.size(), 0, ascii::CHAR_FLAG_WHITESPACE, values, 16
+    );
+    CHECK(1 == result.count);
+    CHECK(2 == result.offset);
+    CHECK(result.invalid);
+    result = ascii::parse_int_fields_flags(
+        "", 0, 0, ascii::CHAR_FLAG_WHITESPACE, values, 16
+    );
+    CHECK(0 == result.count);
+    CHECK(!result.invalid);
+    // Fields of every length, which are converted in up to 16-digit steps
+    for(size_t digits = 1; digits <= 18; ++digits) {
+        const std::string number = std::string("987654321098765432").substr(0, digits);
+        const int64_t value = std::stoll(number);
+        const std::string fields = "-" + number + " " + number + " +" + number;
+        result = ascii::parse_int_fields_flags(
+            fields.data(), fields.size(), 0, ascii::CHAR_FLAG_WHITESPACE, values, 16
+        );
+        CHECK(3 == result.count);
+        CHECK(!result.invalid);
+        CHECK(-value == values[0]);
+        CHECK(value == values[1]);
+        CHECK(value == values[2]);
+        for(size_t i = 0; i < digits; ++i) {
+            std::string invalid = fields;
+            invalid[fields.size() - 1 - i] = (i & 1) ? '/' : ':';
+            result = ascii::parse_int_fields_flags(
+                invalid.data(), invalid.size(), 0, ascii::CHAR_FLAG_WHITESPACE, values, 16
+            );
+            CHECK(2 == result.count);
+            CHECK(result.invalid);
+            CHECK(fields.size() - digits - 1 == result.offset);
+        }
+    }
+    const std::string sign_only = "1 - 2";
+    result = ascii::parse_int_fields_flags(
+        sign_only.data(), sign_only.size(), 0, ascii::CHAR_FLAG_WHITESPACE, values, 16
+    );
+    CHECK(1 == result.count);
+    CHECK(2 == result.offset);
+    CHECK(result.invalid);
+    // Many fields, more than fit in one batch
+    std::string column;
+    std::vector<int64_t> expected;
+    for(int64_t i = 0; i < 1000; ++i) {
+        const int64_t value = (i * 7919) % 100003 - 50000;
+        expected.push_back(value);
+        column += std::to_string(value) + (i % 3 ? ";" : "\n");
+    }
+    std::vector<int64_t> parsed(expected.size() + 1);
+    for(size_t max : {size_t(1), size_t(63), size_t(64), size_t(65), size_t(1001)}) {
+        size_t count = 0;
+        size_t offset = 0;
+        while(true) {
+            const size_t room = std::min(max, parsed.size() - count);
+            result = ascii::parse_int_fields_in(
+                column.data(), column.size(), offset, ascii::char_set(";\n"),
+                &parsed[count], room
+            );
+            CHECK(!result.invalid);
+            count += result.count;
+            offset = result.offset;
+            if(result.count < room) {
+                break;
+            }
+        }
+        CHECK(expected.size() == count);
+        CHECK(std::equal(expected.begin(), expected.end(), parsed.begin()));
+    }
+}
+
+TEST_CASE("format_uint") {
+    char buffer[32];
+    CHECK(1 == ascii::format_uint(0, buffer));
+    CHECK(std::string(buffer, 1) == "0");
+    CHECK(20 == ascii::format_uint(UINT64_MAX, buffer));
+    CHECK(std::string(buffer, 20) == "18446744073709551615");
+    // Powers of 10 and their neighbours, and other values of every length
+    uint64_t power = 1;
+    for(int digits = 1; digits <= 20; ++digits) {
+        const uint64_t tests[] = {
+            power, power - 1, power + 1, power * 7 / 3, power + power / 2,
+        };
+        for(const uint64_t value : tests) {
+            const std::string expected = std::to_string(value);
+            CHECK(expected.size() == ascii::format_uint_length(value));
+            CHECK(expected.size() == ascii::format_uint(value, buffer));
+            CHECK(expected == std::string(buffer, expected.size()));
+        }
+        power *= digits < 20 ? 10 : 1;
+    }
+}
+
+TEST_CASE("format_int") {
+    char buffer[32];
+    const int64_t tests[] = {
+        0, 1, -1, 9, -9, 10, -10, 99, -100, 123456789, -987654321098,
+        INT64_MAX, INT64_MIN, INT64_MIN + 1,
+    };
+    for(const int64_t value : tests) {
+        const std::string expected = std::to_string(value);
+        CHECK(expected.size() == ascii::format_int_length(value));
+        CHECK(expected.size() == ascii::format_int(value, buffer));
+        CHECK(expected == std::string(buffer, expected.size()));
+        // Round trip through `parse_int`
+        CHECK(value == ascii::parse_int(buffer, expected.size()).value);
+    }
+}
+
+TEST_CASE("format_hex") {
+    char buffer[32];
+    CHECK(1 == ascii::format_hex_length(0));
+    CHECK(1 == ascii::format_hex(0, buffer));
+    CHECK(std::string(buffer, 1) == "0");
+    CHECK(8 == ascii::format_hex(0xdeadBEEF, buffer));
+    CHECK(std::string(buffer, 8) == "deadbeef");
+    CHECK(8 == ascii::format_hex(0xdeadBEEF, buffer, true));
+    CHECK(std::string(buffer, 8) == "DEADBEEF");
+    CHECK(16 == ascii::format_hex(UINT64_MAX, buffer));
+    CHECK(std::string(buffer, 16) == "ffffffffffffffff");
+    for(int bit = 0; bit < 64; ++bit) {
+        const uint64_t value = static_cast<uint64_t>(1) << bit;
+        const size_t length = ascii::format_hex(value, buffer);
+        CHECK(static_cast<size_t>(bit / 4 + 1) == length);
+        CHECK(length == ascii::format_hex_length(value));
+        CHECK(value == ascii::parse_uint(buffer, length, 16).value);
+    }
+}
+
+// Check `parse_double` against `strtod`, which is correctly rounded
+// in the C locale used by the tests.
+void check_parse_double(const std::string& str) {
+    char* end;
+    const double expected = std::strtod(str.c_str(), &end);
+    const ascii::parse_double_result result = ascii::parse_double(str.data(), str.size());
+    CHECK(static_cast<size_t>(end - str.c_str()) == result.length);
+    if(expected != expected) {
+        CHECK(result.value != result.value);
+    }
+    else {
+        CHECK(expected == result.value);
+        CHECK(std::signbit(expected) == std::signbit(result.value));
+    }
+}
+
+TEST_CASE("parse_double") {
+    const std::string tests[] = {
+        "0", "-0", "+0", "0.0", "-0.0e10", "1", "-1", "1.5", ".5", "5.", "-.5e1",
+        "3.141592653589793", "2.718281828459045e0", "1e22", "1e23", "1e-22",
+        "123456789012345678", "1234567890123456789", "12345678901234567890",
+        "9007199254740992", "9007199254740993", "9007199254740993.0000000001",
+        "0.1", "0.2", "0.30000000000000004", "1.7976931348623157e308",
+        "1.7976931348623159e308", "2e308", "4.9406564584124654e-324",
+        "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400",
+        "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "0.000000000000000000000000000000123", "000123.456000", "1e+5",
+        "1E-5", "1e", "1e+", "1e-x", "1.e5", "1.5x", "12.34.56", "-", "+",
+        ".", "-.", "e5", "x", "", "inf", "-Infinity", "INFINITE", "nan",
+        "+NaN", "in", "100000000000000000000000e-23", "7e37", "123e-400",
+        "1" + std::string(800, '0') + "e-800",
+    };
+    for(const std::string& test : tests) {
+        check_parse_double(test);
+    }
+    // Numbers with many digits, exercising the slow path
+    check_parse_double("0." + std::string(790, '0') + "1e790");
+    check_parse_double(
+        "2.47032822920623272088284396434110686182529901307162382212792841"
+        "25033775363510437593264991818081799618989828234772285886546332"
+        "83544197954913049015024398963617216213009227862040418432087627"
+        "68811434924096012930108990478512254614148097232094614637614049"
+        "2565460434622440234" + std::string(400, '0') + "1e-324"
+    );
+    // Round trips of values printed with 17 significant digits
+    char printed[64];
+    uint64_t bits = 0x123456789abcdefull;
+    for(int i = 0; i < 20000; ++i) {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if(value != value || value - value != 0) {
+            continue;
+        }
+        const int length = std::snprintf(printed, sizeof(printed), "%.17g", value);
+        const ascii::parse_double_result result = ascii::parse_double(printed, length);
+        CHECK(value == result.value);
+        CHECK(static_cast<size_t>(length) == result.length);
+        const int short_length = std::snprintf(
+            printed, sizeof(printed), "%.*g", 1 + (i % 16), value / 1e300
+        );
+        check_parse_double(std::string(printed, short_length));
+    }
+}
+
+// Reference for `parse_iso8601`: Seconds since the epoch, by counting
+// whole days one year and month at a time.
+int64_t iso8601_seconds_reference(
+    int year, int month, int day, int hour, int minute, int second
+) {
+    int64_t days = 0;
+    for(int y = 1970; y < year; ++y) {
+        days += ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0) ? 366 : 365;
+    }
+    for(int y = year; y < 1970; ++y) {
+        days -= ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0) ? 366 : 365;
+    }
+    const int month_days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    for(int m = 1; m < month; ++m) {
+        days += month_days[m - 1];
+        if(m == 2 && ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)) {
+            ++days;
+        }
+    }
+    days += day - 1;
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+TEST_CASE("parse_iso8601") {
+    ascii::parse_iso8601_result result = ascii::parse_iso8601(
+        "2026-10-17T12:34:56.789Z INFO", 29
+    );
+    CHECK(1792240496789000000ll == result.nanoseconds);
+    CHECK(24 == result.length);
+    CHECK(ascii::npos == result.error);
+    result = ascii::parse_iso8601("1970-01-01T00:00:00Z", 20);
+    CHECK(0 == result.nanoseconds);
+    CHECK(20 == result.length);
+    result = ascii::parse_iso8601("1970-01-01 00:00:00", 19);
+    CHECK(0 == result.nanoseconds);
+    CHECK(19 == result.length);
+    result = ascii::parse_iso8601("1970-01-01t01:00:00+01:00", 25);
+    CHECK(0 == result.nanoseconds);
+    CHECK(25 == result.length);
+    result = ascii::parse_iso8601("1969-12-31T23:30:00.5-00:30", 27);
+    CHECK(500000000 == result.nanoseconds);
+    result = ascii::parse_iso8601("1969-12-31T23:59:59.999999999999z", 33);
+    CHECK(-1 == result.nanoseconds);
+    CHECK(33 == result.length);
+    result = ascii::parse_iso8601("2016-12-31T23:59:60Z", 20);
+    CHECK(1483228800000000000ll == result.nanoseconds);
+    result = ascii::parse_iso8601("2000-02-29T00:00:00,25Z", 23);
+    CHECK(951782400250000000ll == result.nanoseconds);
+    CHECK(23 == result.length);
+    // Errors report the offset of the problem
+    const struct {
+        const char* str;
+        size_t error;
+    } errors[] = {
+        {"", 0}, {"2026", 4}, {"2026-10-17T12:34:5", 18},
+        {"x026-10-17T12:34:56Z", 0}, {"2026/10-17T12:34:56Z", 4},
+        {"2026-1x-17T12:34:56Z", 6}, {"2026-10-17X12:34:56Z", 10},
+        {"2026-10-17T12-34:56Z", 13}, {"2026-10-17T12:34:5xZ", 18},
+        {"2026-10-17T12:34.56Z", 16}, {"2026-13-17T12:34:56Z", 5},
+        {"2026-00-17T12:34:56Z", 5}, {"2026-02-29T12:34:56Z", 8},
+        {"2026-10-32T12:34:56Z", 8}, {"2026-10-17T24:00:00Z", 11},
+        {"2026-10-17T12:60:56Z", 14}, {"2026-10-17T12:34:61Z", 17},
+        {"2026-10-17T12:34:56.Z", 20}, {"2026-10-17T12:34:56+1", 21},
+        {"2026-10-17T12:34:56+01:6", 24}, {"2026-10-17T12:34:56+0100", 22},
+        {"2026-10-17T12:34:56+24:00", 20}, {"2026-10-17T12:34:56+01:60", 23},
+        {"2263-01-01T00:00:00Z", 0}, {"1600-01-01T00:00:00Z", 0},
+    };
+    for(const auto& test : errors) {
+        result = ascii::parse_iso8601(test.str, std::strlen(test.str));
+        CHECK(test.error == result.error);
+        CHECK(0 == result.length);
+    }
+    // Compare with the reference for many dates
+    char buffer[64];
+    for(int year = 1678; year <= 2261; year += 7) {
+        for(int month = 1; month <= 12; ++month) {
+            const int day = 1 + (year * 13 + month * 7) % 28;
+            const int hour = (year + month) % 24;
+            const int minute = (year * 3 + month) % 60;
+            const int second = (year + month * 11) % 60;
+            const int length = std::snprintf(buffer, sizeof(buffer),
+                "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                year, month, day, hour, minute, second, month * 7
+            );
+            result = ascii::parse_iso8601(buffer, static_cast<size_t>(length));
+            CHECK(static_cast<size_t>(length) == result.length);
+            CHECK(iso8601_seconds_reference(year, month, day, hour, minute, second) *
+                1000000000 + month * 7000000 == result.nanoseconds);
+        }
+    }
+}
+
+TEST_CASE("parse_ipv4") {
+    ascii::parse_ipv4_result result = ascii::parse_ipv4("192.168.0.1 - -", 15);
+    CHECK(0xc0a80001u == result.address);
+    CHECK(11 == result.length);
+    CHECK(ascii::npos == result.error);
+    result = ascii::parse_ipv4("255.255.255.255", 15);
+    CHECK(0xffffffffu == result.address);
+    CHECK(15 == result.length);
+    result = ascii::parse_ipv4("0.0.0.0", 7);
+    CHECK(0 == result.address);
+    CHECK(7 == result.length);
+    const std::string padded = "10.20.30.40:8080 and some more text after it";
+    result = ascii::parse_ipv4(padded.data(), padded.size());
+    CHECK(0x0a141e28u == result.address);
+    CHECK(11 == result.length);
+    const struct {
+        const char* str;
+        size_t error;
+    } errors[] = {
+        {"", 0}, {".1.2.3", 0}, {"1..2.3", 2}, {"1.2.3", 5}, {"1.2.3.", 6},
+        {"256.1.1.1", 0}, {"1.2.300.4", 4}, {"1.2.3.999", 6}, {"01.2.3.4", 0},
+        {"1.2.3.04", 6}, {"1234.1.1.1", 3}, {"1.2.3.4567", 9}, {"1:2.3.4", 1},
+        {"1.2.3 .4", 5}, {"x", 0}, {"1.2.3.-4", 6},
+    };
+    for(const auto& test : errors) {
+        result = ascii::parse_ipv4(test.str, std::strlen(test.str));
+        CHECK(test.error == result.error);
+        CHECK(0 == result.length);
+    }
+}
+
+TEST_CASE("format_ipv4") {
+    char buffer[ascii::IPV4_MAX_LENGTH];
+    CHECK(11 == ascii::format_ipv4(0xc0a80001u, buffer));
+    CHECK(std::string(buffer, 11) == "192.168.0.1");
+    CHECK(15 == ascii::format_ipv4(0xffffffffu, buffer));
+    CHECK(std::string(buffer, 15) == "255.255.255.255");
+    CHECK(7 == ascii::format_ipv4(0, buffer));
+    CHECK(std::string(buffer, 7) == "0.0.0.0");
+    // Round trips
+    uint32_t address = 1;
+    for(int i = 0; i < 10000; ++i) {
+        address = address * 1664525u + 1013904223u;
+        const uint32_t shifted = address >> (i % 32);
+        const size_t length = ascii::format_ipv4(shifted, buffer);
+        const ascii::parse_ipv4_result result = ascii::parse_ipv4(buffer, length);
+        CHECK(shifted == result.address);
+        CHECK(length == result.length);
+    }
+}
+
+TEST_CASE("parse_uuid") {
+    const char* uuid = "4f9a2c1e-7b3d-4E8F-9a0b-1c2d3e4f5a6b";
+    char bytes[16];
+    CHECK(ascii::npos == ascii::parse_uuid(uuid, 36, bytes));
+    CHECK(std::string(bytes, 16) == (
+        "\x4f\x9a\x2c\x1e\x7b\x3d\x4e\x8f\x9a\x0b\x1c\x2d\x3e\x4f\x5a\x6b"
+    ));
+    char formatted[ascii::UUID_LENGTH];
+    ascii::format_uuid(bytes, formatted);
+    CHECK(std::string(formatted, 36) == "4f9a2c1e-7b3d-4e8f-9a0b-1c2d3e4f5a6b");
+    ascii::format_uuid(bytes, formatted, true);
+    CHECK(std::string(formatted, 36) == "4F9A2C1E-7B3D-4E8F-9A0B-1C2D3E4F5A6B");
+    // Every invalid byte, and every truncation, is reported
+    for(size_t i = 0; i < 36; ++i) {
+        std::string invalid = uuid;
+        const bool dash = i == 8 || i == 13 || i == 18 || i == 23;
+        invalid[i] = dash ? '0' : (i & 1 ? 'g' : '-');
+        CHECK(i == ascii::parse_uuid(invalid.data(), invalid.size(), bytes));
+        CHECK(i == ascii::parse_uuid(uuid, i, bytes));
+        if(i > 0) {
+            // Earlier invalid digits are reported before truncation
+            invalid = uuid;
+            invalid[i - 1] = 'x';
+            CHECK(i - 1 == ascii::parse_uuid(invalid.data(), i, bytes));
+        }
+    }
+}
+
+TEST_CASE("base64_encode") {
+    const char* tests[][2] = {
+        {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"},
+        {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+    };
+    char buffer[16];
+    for(const auto& test : tests) {
+        const size_t length = std::strlen(test[0]);
+        CHECK(std::strlen(test[1]) == ascii::base64_encoded_length(length));
+        const size_t written = ascii::base64_encode(test[0], length, buffer);
+        CHECK(std::string(buffer, written) == test[1]);
+        const size_t unpadded = ascii::base64_encode(
+            test[0], length, buffer, ascii::BASE64_NO_PADDING
+        );
+        CHECK(unpadded == ascii::base64_encoded_length(length, ascii::BASE64_NO_PADDING));
+        CHECK(std::string(buffer, unpadded) == std::string(test[1]).substr(
+            0, std::string(test[1]).find('=')
+        ));
+    }
+    CHECK(4 == ascii::base64_encode("\xfb\xff", 2, buffer));
+    CHECK(std::string(buffer, 4) == "+/8=");
+    CHECK(4 == ascii::base64_encode("\xfb\xff", 2, buffer, ascii::BASE64_URL));
+    CHECK(std::string(buffer, 4) == "-_8=");
+    // Compare every length and alignment with a scalar reference
+    const char* alphabet = (
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+    );
+    std::string input;
+    for(int i = 0; i < 300; ++i) {
+        input += static_cast<char>(i * 131 + (i >> 3));
+    }
+    for(size_t length = 0; length <= input.size(); ++length) {
+        std::string expected;
+        for(size_t i = 0; i < length; i += 3) {
+            uint32_t bits = static_cast<uint32_t>(static_cast<unsigned char>(input[i])) << 16;
+            if(i + 1 < length) {
+                bits |= static_cast<uint32_t>(static_cast<unsigned char>(input[i + 1])) << 8;
+            }
+            if(i + 2 < length) {
+                bits |= static_cast<unsigned char>(input[i + 2]);
+            }
+            for(size_t j = 0; j < 4; ++j) {
+                expected += j <= length - i ? alphabet[(bits >> (18 - 6 * j)) & 0x3f] : '=';
+            }
+        }
+        std::string output(expected.size(), '\0');
+        CHECK(expected.size() == ascii::base64_encode(
+            input.data(), length, &output[0], ascii::BASE64_URL
+        ));
+        CHECK(expected == output);
+    }
+}
+
+TEST_CASE("base64_decode") {
+    const char* tests[][2] = {
+        {"", ""}, {"Zg==", "f"}, {"Zm8=", "fo"}, {"Zm9v", "foo"},
+        {"Zm9vYg==", "foob"}, {"Zm9vYmE=", "fooba"}, {"Zm9vYmFy", "foobar"},
+        {"Zg", "f"}, {"Zm8", "fo"}, {"Zm9vYg", "foob"},
+    };
+    char buffer[16];
+    for(const auto& test : tests) {
+        const ascii::base64_decode_result result = ascii::base64_decode(
+            test[0], std::strlen(test[0]), buffer
+        );
+        CHECK(ascii::npos == result.error);
+        CHECK(std::string(buffer, result.length) == test[1]);
+    }
+    ascii::base64_decode_result result = ascii::base64_decode("+/8=", 4, buffer);
+    CHECK(ascii::npos == result.error);
+    CHECK(std::string(buffer, result.length) == "\xfb\xff");
+    result = ascii::base64_decode("-_8=", 4, buffer);
+    CHECK(0 == result.error);
+    result = ascii::base64_decode("-_8=", 4, buffer, ascii::BASE64_URL);
+    CHECK(ascii::npos == result.error);
+    CHECK(std::string(buffer, result.length) == "\xfb\xff");
+    const struct {
+        const char* str;
+        int options;
+        size_t error;
+        size_t length;
+    } errors[] = {
+        {"Z", 0, 0, 0}, {"Zm9vZ", 0, 4, 3}, {"Zg=", 0, 3, 1}, {"Zg===", 0, 4, 1},
+        {"Z===", 0, 1, 0}, {"Zm9v=", 0, 4, 3}, {"Zg==Zg==", 0, 4, 1},
+        {"Zm9v Zm9v", 0, 4, 3}, {"Zm9v\nZm9v\n", ascii::BASE64_SKIP_WHITESPACE, ascii::npos, 6},
+        {"Zg= =\n", ascii::BASE64_SKIP_WHITESPACE, ascii::npos, 1},
+        {"Zg= =\nx", ascii::BASE64_SKIP_WHITESPACE, 6, 1}, {"Zm9\xff", 0, 3, 2},
+    };
+    for(const auto& test : errors) {
+        result = ascii::base64_decode(
+            test.str, std::strlen(test.str), buffer, test.options
+        );
+        CHECK(test.error == result.error);
+        CHECK(test.length == result.length);
+    }
+    // Round trips at every length, with line breaks, and with an
+    // invalid byte at every offset
+    std::string input;
+    for(int i = 0; i < 300; ++i) {
+        input += static_cast<char>(i * 131 + (i >> 3));
+    }
+    for(size_t length = 0; length <= input.size(); ++length) {
+        std::string encoded(ascii::base64_encoded_length(length), '\0');
+        ascii::base64_encode(input.data(), length, &encoded[0]);
+        std::string output(encoded.size() * 3 / 4, '\0');
+        result = ascii::base64_decode(encoded.data(), encoded.size(), &output[0]);
+        CHECK(ascii::npos == result.error);
+        CHECK(length == result.length);
+        CHECK(output.substr(0, length) == input.substr(0, length));
+        std::string wrapped;
+        for(size_t i = 0; i < encoded.size(); i += 76) {
+            wrapped += encoded.substr(i, 76) + "\r\n";
+        }
+        output.assign(wrapped.size() * 3 / 4, '\0');
+        result = ascii::base64_decode(
+            wrapped.data(), wrapped.size(), &output[0], ascii::BASE64_SKIP_WHITESPACE
+        );
+        CHECK(ascii::npos == result.error);
+        CHECK(length == result.length);
+        CHECK(output.substr(0, length) == input.substr(0, length));
+        if(length % 3 == 0 && length > 0) {
+            result = ascii::base64_decode(wrapped.data(), wrapped.size(), &output[0]);
+            CHECK((encoded.size() < 76 ? encoded.size() : 76) == result.error);
+        }
+    }
+    std::string encoded(ascii::base64_encoded_length(input.size()), '\0');
+    ascii::base64_encode(input.data(), input.size(), &encoded[0]);
+    std::string output(encoded.size(), '\0');
+    for(size_t i = 0; i < encoded.size() - 1; ++i) {
+        std::string invalid = encoded;
+        invalid[i] = '.';
+        result = ascii::base64_decode(invalid.data(), invalid.size(), &output[0]);
+        CHECK(i == result.error);
+        CHECK(i / 4 * 3 + (i % 4 ? i % 4 - 1 : 0) == result.length);
+        CHECK(output.substr(0, i / 4 * 3) == input.substr(0, i / 4 * 3));
+    }
+}
+
+TEST_CASE("percent_encode") {
+    const char* tests[][2] = {
+        {"", ""}, {"abc", "abc"}, {"a b", "a%20b"}, {"A-Z_a.z~09", "A-Z_a.z~09"},
+        {"/path?q=1&r=\xc3\xa9", "%2Fpath%3Fq%3D1%26r%3D%C3%A9"}, {"%", "%25"},
+    };
+    char buffer[64];
+    for(const auto& test : tests) {
+        const size_t length = std::strlen(test[0]);
+        CHECK(std::strlen(test[1]) == ascii::percent_encoded_length(test[0], length));
+        const size_t written = ascii::percent_encode(test[0], length, buffer);
+        CHECK(std::string(buffer, written) == test[1]);
+    }
+    // A custom set keeps path separators
+    const ascii::char_set path = ascii::URL_UNRESERVED | ascii::char_set("/");
+    const size_t written = ascii::percent_encode("/a b/c", 6, buffer, path);
+    CHECK(std::string(buffer, written) == "/a%20b/c");
+    // Long inputs with escapes at every offset
+    for(size_t i = 0; i < 100; ++i) {
+        std::string input(100, 'x');
+        input[i] = ' ';
+        std::string output(ascii::percent_encoded_length(input.data(), input.size()), '\0');
+        CHECK(102 == output.size());
+        CHECK(102 == ascii::percent_encode(input.data(), input.size(), &output[0]));
+        CHECK(output == std::string(i, 'x') + "%20" + std::string(99 - i, 'x'));
+    }
+}
+
+TEST_CASE("percent_decode") {
+    const char* tests[][2] = {
+        {"", ""}, {"abc", "abc"}, {"a%20b", "a b"}, {"%2fpath%3F", "/path?"},
+        {"%C3%A9+", "\xc3\xa9+"}, {"%25%25", "%%"},
+    };
+    char buffer[64];
+    for(const auto& test : tests) {
+        const ascii::percent_decode_result result = ascii::percent_decode(
+            test[0], std::strlen(test[0]), buffer
+        );
+        CHECK(ascii::npos == result.error);
+        CHECK(std::string(buffer, result.length) == test[1]);
+    }
+    ascii::percent_decode_result result = ascii::percent_decode("a+b%2B", 6, buffer, true);
+    CHECK(ascii::npos == result.error);
+    CHECK(std::string(buffer, result.length) == "a b+");
+    const struct {
+        const char* str;
+        size_t error;
+        size_t length;
+    } errors[] = {
+        {"%", 0, 0}, {"a%2", 1, 1}, {"ab%g0", 2, 2}, {"%20%0g", 3, 1}, {"%%20", 0, 0},
+    };
+    for(const auto& test : errors) {
+        result = ascii::percent_decode(test.str, std::strlen(test.str), buffer);
+        CHECK(test.error == result.error);
+        CHECK(test.length == result.length);
+    }
+    // In place, with escapes at every offset of a long input
+    for(size_t i = 0; i < 100; ++i) {
+        std::string input = std::string(i, 'x') + "%41" + std::string(99 - i, 'y');
+        result = ascii::percent_decode(input.data(), input.size(), &input[0]);
+        CHECK(ascii::npos == result.error);
+        CHECK(input.substr(0, result.length) == std::string(i, 'x') + "A" + std::string(99 - i, 'y'));
+    }
+    // Round trip of every byte value
+    std::string all;
+    for(int i = 0; i < 256; ++i) {
+        all += static_cast<char>(i);
+    }
+    std::string encoded(ascii::percent_encoded_length(all.data(), all.size()), '\0');
+    ascii::percent_encode(all.data(), all.size(), &encoded[0]);
+    result = ascii::percent_decode(encoded.data(), encoded.size(), &encoded[0]);
+    CHECK(ascii::npos == result.error);
+    CHECK(encoded.substr(0, result.length) == all);
+}
+
+TEST_CASE("escape") {
+    const struct {
+        int mode;
+        const char* str;
+        const char* expected;
+    } tests[] = {
+        {ascii::ESCAPE_JSON, "", ""},
+        {ascii::ESCAPE_JSON, "plain text", "plain text"},
+        {ascii::ESCAPE_JSON, "a\"b\\c\nd\te\x01\x1f\x7f\xc3\xa9", "a\\\"b\\\\c\\nd\\te\\u0001\\u001f\x7f\xc3\xa9"},
+        {ascii::ESCAPE_JSON, "\b\f\r\a\v", "\\b\\f\\r\\u0007\\u000b"},
+        {ascii::ESCAPE_C, "a\"b\\c\nd\te\x01\x7f\xc3\xa9", "a\\\"b\\\\c\\nd\\te\\001\\177\\303\\251"},
+        {ascii::ESCAPE_C, "\a\v'", "\\a\\v'"},
+        {ascii::ESCAPE_HTML, "<a href=\"x\">Tom & Jerry's</a>\n", (
+            "&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&#39;s&lt;/a&gt;\n"
+        )},
+        {ascii::ESCAPE_CARET, "a\x1b[0m\x7f\t^", "a^[[0m^?^I^"},
+    };
+    char buffer[128];
+    for(const auto& test : tests) {
+        const size_t length = std::strlen(test.str);
+        CHECK(std::strlen(test.expected) == ascii::escaped_length(test.str, length, test.mode));
+        const size_t written = ascii::escape(test.str, length, buffer, test.mode);
+        CHECK(std::string(buffer, written) == test.expected);
+    }
+    const std::string nul("a\0b", 3);
+    const size_t written = ascii::escape(nul.data(), nul.size(), buffer);
+    CHECK(std::string(buffer, written) == "a\\u0000b");
+    // Long inputs with escaped bytes at every offset, in every mode
+    const int modes[] = {
+        ascii::ESCAPE_JSON, ascii::ESCAPE_C, ascii::ESCAPE_HTML, ascii::ESCAPE_CARET
+    };
+    const char* escapes[] = {"\\n", "\\n", "&lt;", "^J"};
+    for(int mode = 0; mode < 4; ++mode) {
+        for(size_t i = 0; i < 100; ++i) {
+            std::string input(100, 'x');
+            input[i] = modes[mode] == ascii::ESCAPE_HTML ? '<' : '\n';
+            const std::string expected = (
+                std::string(i, 'x') + escapes[mode] + std::string(99 - i, 'x')
+            );
+            std::string output(ascii::escaped_length(input.data(), input.size(), modes[mode]), '\0');
+            CHECK(expected.size() == output.size());
+            CHECK(output.size() == ascii::escape(input.data(), input.size(), &output[0], modes[mode]));
+            CHECK(expected == output);
+        }
+    }
+}
+
+// Doubles single quotes, as in SQL string literals.
+size_t sql_quote_length(const unsigned char) {
+    return 2;
+}
+
+size_t sql_quote_write(const unsigned char ch, char* dst) {
+    dst[0] = static_cast<char>(ch);
+    dst[1] = static_cast<char>(ch);
+    return 2;
+}
+
+TEST_CASE("escape_table") {
+    // Each table's lengths match what it writes, for every byte
+    for(int mode = ascii::ESCAPE_JSON; mode <= ascii::ESCAPE_CARET; ++mode) {
+        const ascii::escape_table table = ascii::get_escape_table(mode);
+        for(int ch = 0; ch < 256; ++ch) {
+            const bool escaped = ch > 0x7f ? table.non_ascii : table.special.contains(ch);
+            if(escaped) {
+                char buffer[16];
+                const unsigned char uch = static_cast<unsigned char>(ch);
+                CHECK(table.length(uch) == table.write(uch, buffer));
+            }
+        }
+    }
+    // Unknown modes escape nothing
+    char buffer[64];
+    const char* str = "<\"\n\x01\xff>";
+    CHECK(6 == ascii::escaped_length(str, 6, 99));
+    CHECK(6 == ascii::escape(str, 6, buffer, -1));
+    CHECK(std::string(buffer, 6) == str);
+    // Custom tables
+    const ascii::escape_table sql = {
+        ascii::char_set("'"), false, sql_quote_length, sql_quote_write
+    };
+    const char* quoted = "it's 'quoted'";
+    const size_t length = std::strlen(quoted);
+    CHECK(16 == ascii::escaped_length(quoted, length, sql));
+    CHECK(16 == ascii::escape(quoted, length, buffer, sql));
+    CHECK(std::string(buffer, 16) == "it''s ''quoted''");
+}
+
+TEST_CASE("unescape_json") {
+    const char* tests[][2] = {
+        {"", ""}, {"plain", "plain"}, {"a\\\"b\\\\c\\/d", "a\"b\\c/d"},
+        {"\\b\\f\\n\\r\\t", "\b\f\n\r\t"}, {"\\u0041\\u00e9\\u20AC", "A\xc3\xa9\xe2\x82\xac"},
+        {"\\ud83d\\ude00!", "\xf0\x9f\x98\x80!"},
+    };
+    char buffer[64];
+    for(const auto& test : tests) {
+        const ascii::unescape_result result = ascii::unescape_json(
+            test[0], std::strlen(test[0]), buffer
+        );
+        CHECK(ascii::npos == result.error);
+        CHECK(std::string(buffer, result.length) == test[1]);
+    }
+    const struct {
+        const char* str;
+        size_t error;
+        size_t length;
+    } errors[] = {
+        {"\\", 0, 0}, {"ab\\x41", 2, 2}, {"\\u004", 0, 0}, {"a\\u00g1", 1, 1},
+        {"\\n\\ud83d", 2, 1}, {"\\ud83dx\\ude00", 0, 0}, {"\\ude00", 0, 0},
+        {"\\ud83d\\u0041", 0, 0}, {"\\'", 0, 0},
+    };
+    for(const auto& test : errors) {
+        const ascii::unescape_result result = ascii::unescape_json(
+            test.str, std::strlen(test.str), buffer
+        );
+        CHECK(test.error == result.error);
+        CHECK(test.length == result.length);
+    }
+}
+
+TEST_CASE("unescape_c") {
+    const char* tests[][2] = {
+        {"", ""}, {"plain", "plain"}, {"a\\\"b\\\\c\\'d\\?", "a\"b\\c'd?"},
+        {"\\a\\b\\f\\n\\r\\t\\v", "\a\b\f\n\r\t\v"}, {"\\101\\7x\\0101", "A\x07x\x08" "1"},
+        {"\\x41\\x0041g\\xe9", "AAg\xe9"}, {"\\u00e9\\U0001F600", "\xc3\xa9\xf0\x9f\x98\x80"},
+    };
+    char buffer[64];
+    for(const auto& test : tests) {
+        const ascii::unescape_result result = ascii::unescape_c(
+            test[0], std::strlen(test[0]), buffer
+        );
+        CHECK(ascii::npos == result.error);
+        CHECK(std::string(buffer, result.length) == test[1]);
+    }
+    const struct {
+        const char* str;
+        size_t error;
+        size_t length;
+    } errors[] = {
+        {"\\", 0, 0}, {"ab\\q", 2, 2}, {"\\400", 0, 0}, {"\\x", 0, 0},
+        {"\\x100", 0, 0}, {"a\\u12", 1, 1}, {"\\U00110000", 0, 0}, {"\\ud800", 0, 0},
+    };
+    for(const auto& test : errors) {
+        const ascii::unescape_result result = ascii::unescape_c(
+            test.str, std::strlen(test.str), buffer
+        );
+        CHECK(test.error == result.error);
+        CHECK(test.length == result.length);
+    }
+    // Round trips through `escape`, in place, for every byte value at
+    // every offset of a long input
+    for(int mode = 0; mode < 2; ++mode) {
+        for(int ch = 0; ch < 256; ch += 7) {
+            for(size_t i = 0; i < 80; i += 3) {
+                std::string input(80, 'x');
+                input[i] = static_cast<char>(ch);
+                const int escape_mode = mode ? ascii::ESCAPE_C : ascii::ESCAPE_JSON;
+                std::string escaped(ascii::escaped_length(input.data(), input.size(), escape_mode), '\0');
+                ascii::escape(input.data(), input.size(), &escaped[0], escape_mode);
+                const ascii::unescape_result result = mode ? (
+                    ascii::unescape_c(escaped.data(), escaped.size(), &escaped[0])
+                ) : (
+                    ascii::unescape_json(escaped.data(), escaped.size(), &escaped[0])
+                );
+                CHECK(ascii::npos == result.error);
+                CHECK(escaped.substr(0, result.length) == input);
+            }
+        }
+    }
+}
+
+TEST_CASE("sanitize") {
+    std::string str = "a\tb\nc\x1b[0m\x7f\xc3\xa9\r";
+    CHECK(str.size() == ascii::sanitize(&str[0], str.size()));
+    CHECK(str == "a?b?c?[0m?\xc3\xa9?");
+    str = "a\tb\nc\x1b[0m\x7f\xc3\xa9\r";
+    CHECK(str.size() == ascii::sanitize(
+        &str[0], str.size(), ascii::SANITIZE_REPLACE | ascii::SANITIZE_KEEP_TAB_NEWLINE, ' '
+    ));
+    CHECK(str == "a\tb\nc [0m \xc3\xa9 ");
+    str = "a\tb\nc\x1b[0m\x7f\xc3\xa9\r";
+    str.resize(ascii::sanitize(&str[0], str.size(), ascii::SANITIZE_DROP));
+    CHECK(str == "abc[0m\xc3\xa9");
+    str = "a\tb\nc\x1b[0m\x7f\xc3\xa9\r";
+    str.resize(ascii::sanitize(
+        &str[0], str.size(), ascii::SANITIZE_DROP | ascii::SANITIZE_KEEP_TAB_NEWLINE
+    ));
+    CHECK(str == "a\tb\nc[0m\xc3\xa9");
+    CHECK(0 == ascii::sanitize(&str[0], 0, ascii::SANITIZE_DROP));
+    // Compare long inputs of mixed bytes with a scalar reference
+    std::string input;
+    uint32_t random = 1;
+    for(int i = 0; i < 1000; ++i) {
+        random = random * 1664525u + 1013904223u;
+        // Runs of clean bytes with occasional control characters
+        input += static_cast<char>((random >> 24) < 0xd0 ? 'a' + (random >> 28) : random >> 8);
+    }
+    for(int mode = 0; mode < 4; ++mode) {
+        for(size_t offset = 0; offset < 40; ++offset) {
+            const bool keep = (mode & ascii::SANITIZE_KEEP_TAB_NEWLINE) != 0;
+            std::string expected;
+            for(size_t i = offset; i < input.size(); ++i) {
+                const char ch = input[i];
+                const bool sanitized = ascii::is_control_char(
+                    static_cast<unsigned char>(ch)
+                ) && !(keep && (ch == '\t' || ch == '\n'));
+                if(!sanitized) {
+                    expected += ch;
+                }
+                else if(!(mode & ascii::SANITIZE_DROP)) {
+                    expected += '~';
+                }
+            }
+            std::string actual = input.substr(offset);
+            actual.resize(ascii::sanitize(&actual[0], actual.size(), mode, '~'));
+            CHECK(expected == actual);
+        }
+    }
+}
+
+TEST_CASE("strip_ansi_sequences") {
+    const char* tests[][2] = {
+        {"", ""}, {"plain text", "plain text"},
+        {"\x1b[1;31mred\x1b[0m text", "red text"},
+        {"\x1b[38;2;255;0;0mx\x1b[K\x1b[2J\x1b[?25h", "x"},
+        {"\x1b]0;window title\x07prompt$ ", "prompt$ "},
+        {"\x1b]8;;http://a.b/\x1b\\link\x1b]8;;\x1b\\", "link"},
+        {"\x1b(Bcharset\x1bMreverse\x1b=", "charsetreverse"},
+        {"\xc3\xa9\x1b[32m\xe2\x9c\x93\x1b[m", "\xc3\xa9\xe2\x9c\x93"},
+        // Interrupted and truncated sequences
+        {"\x1b[31\nnext", "\nnext"}, {"\x1b]title\nnext", "\nnext"},
+        {"text\x1b[1;3", "text"}, {"text\x1b", "text"}, {"a\x1b\x1b[mb", "ab"},
+    };
+    for(const auto& test : tests) {
+        std::string str = test[0];
+        str.resize(ascii::strip_ansi_sequences(&str[0], str.size()));
+        CHECK(str == test[1]);
+    }
+    // Sequences at every offset of long inputs
+    for(size_t i = 0; i < 100; ++i) {
+        std::string str = std::string(i, 'x') + "\x1b[1;32m" + std::string(100 - i, 'y');
+        str.resize(ascii::strip_ansi_sequences(&str[0], str.size()));
+        CHECK(str == std::string(i, 'x') + std::string(100 - i, 'y'));
+    }
+}
+
+TEST_CASE("collapse_whitespace") {
+    const char* tests[][2] = {
+        {"", ""}, {"   ", ""}, {"word", "word"}, {"  two  words  ", "two words"},
+        {"a\tb\n\nc\r\n d\v\fe", "a b c d e"}, {" \xc3\xa9 \xe2\x9c\x93 ", "\xc3\xa9 \xe2\x9c\x93"},
+    };
+    char buffer[64];
+    for(const auto& test : tests) {
+        const size_t length = std::strlen(test[0]);
+        size_t written = ascii::collapse_whitespace(test[0], length, buffer);
+        CHECK(std::string(buffer, written) == test[1]);
+        std::string str = test[0];
+        str.resize(ascii::collapse_whitespace(&str[0], str.size()));
+        CHECK(str == test[1]);
+    }
+    // Compare long inputs of words and whitespace runs with a reference
+    const char* pieces[] = {"lorem", " ", "  ", "\t", "\r\n", "ipsum", "x", "\n\n\n"};
+    uint32_t random = 1;
+    std::string input;
+    for(int i = 0; i < 400; ++i) {
+        random = random * 1664525u + 1013904223u;
+        input += pieces[random >> 29];
+    }
+    for(size_t offset = 0; offset < 40; ++offset) {
+        std::string expected;
+        bool previous = true;
+        for(size_t i = offset; i < input.size(); ++i) {
+            const bool whitespace = ascii::is_whitespace_char(input[i]);
+            if(!whitespace) {
+                expected += input[i];
+            }
+            else if(!previous) {
+                expected += ' ';
+            }
+            previous = whitespace;
+        }
+        if(!expected.empty() && expected.back() == ' ') {
+            expected.pop_back();
+        }
+        std::string copied(input.size() - offset, '\0');
+        copied.resize(ascii::collapse_whitespace(
+            input.data() + offset, input.size() - offset, &copied[0]
+        ));
+        CHECK(expected == copied);
+        std::string str = input.substr(offset);
+        str.resize(ascii::collapse_whitespace(&str[0], str.size()));
+        CHECK(expected == str);
+    }
+}